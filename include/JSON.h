@@ -27,18 +27,22 @@
 #include <istream>
 #include <ostream>
 #include <sstream>
+#include <string_view>
 
 #include "JsonType.hpp"
 #include "JsonLiteral.hpp"
 #include "JsonObject.h"
 #include "JsonArray.h"
+#include "JsonIndex.h"
+#include "JsonKernels.h"
+#include "JsonArena.h"
+#include "JsonTreeBuilder.hpp"
 
 
 namespace tcajson {
 
 
 #define TCAJSON_VERSION    "v2.5.9"
-#define TCAJSON_ERRSTRLEN   48
 
 
 /* std::ostream support */
@@ -51,7 +55,12 @@ std::ostream& operator<< ( std::ostream & strm, const JsonString  & str );
 
 
 /** The JSON class is the primary interface for parsing JSON documents
-  * into JsonItems via strings or streams.
+  * into JsonItems via strings or streams. The root of a document may
+  * be any JSON value, and is an empty JsonObject by default. The
+  * objects, arrays and strings of a document draw their members, keys
+  * and payloads from the memory resource of the document, which is the
+  * default resource unless one is given. Moving a document transfers
+  * its tree without copying it, and release() takes the root out of it.
  **/
 class JSON {
 
@@ -61,20 +70,54 @@ class JSON {
     JSON  ( std::istream      & buf );
     JSON  ( const JsonObject  & jobj );
     JSON  ( const JSON        & json );
+    JSON  ( JSON             && json );
+    explicit JSON ( std::pmr::memory_resource * mr );
 
     ~JSON();
 
     JSON&        operator= ( const JSON & json );
+    JSON&        operator= ( JSON && json );
 
-    bool         parse     ( const std::string & str, bool clear = true );
+    bool         parse     ( std::string_view    str, bool clear = true );
     bool         parse     ( std::istream      & buf, bool clear = true );
+    bool         parseIndexed ( std::string_view str, bool clear = true );
+    bool         parseFile ( const std::string & filename, bool clear = true );
+    bool         parse     ( std::string_view    str,
+                             const JsonProjection & proj, bool clear = true );
     void         clear();
     bool         empty() const;
 
+    /** Return the root value of this document, of any type */
+    JsonType*        getRoot()       { return this->_root; }
+    const JsonType*  getRoot() const { return this->_root; }
+
+    JsonType*    release();
+
     /** Return the underlying JsonObject for this document */
-    JsonObject&  getJSON() { return this->_root; }
+    JsonObject&  getJSON() noexcept(false);
     JsonObject&  json()    { return this->getJSON(); }
 
+    JsonArray&   getArray() noexcept(false);
+
+    void         setValidateUtf8 ( bool validate );
+    bool         getValidateUtf8() const;
+
+    void         setUseArena ( bool arena );
+    bool         getUseArena() const { return _arena != nullptr; }
+    JsonArena*   getArena()          { return _arena; }
+
+    void         setRecycleLimit ( size_t nodes );
+    size_t       getRecycleLimit() const;
+    void         shrink();
+
+    void         setMemoryResource ( std::pmr::memory_resource * mr );
+    std::pmr::memory_resource*  getMemoryResource() const
+    {
+        if ( _arena != nullptr )
+            return _arena;
+        return _mr;
+    }
+
     size_t       getErrorPos() const;
     std::string  getErrorStr() const;
 
@@ -90,36 +133,42 @@ class JSON {
         return target;
     }
 
-    static bool         IsSeparator  ( std::istream   & buf );
+    static bool         IsSeparator  ( char    c );
+    static bool         IsSpace      ( char    c );
+    static bool         IsDigit      ( char    c );
     static bool         IsValidChar  ( char    c );
+    static bool         IsValidUtf8  ( std::string_view str );
+    static void         AppendUtf8   ( std::string & str, uint32_t cp );
+    static JsonType*    Copy         ( const JsonType * item,
+                                       const JsonAllocator & alloc = JsonAllocator() );
     static std::string  TypeToString ( json_t  t );
     static std::string  ToString     ( const JsonType * item, bool asJson = true );
     static std::string  Version();
 
+    static std::string  ActiveImplementation();
+    static bool         SetImplementation ( const std::string & name );
 
-  private:
-
-    bool   parseString    ( std::istream & buf, JsonString  & str );
-    bool   parseArray     ( std::istream & buf, JsonArray   & ary );
-    bool   parseObject    ( std::istream & buf, JsonObject  & obj );
-    bool   parseNumber    ( std::istream & buf, JsonNumber  & num );
-    bool   parseBoolean   ( std::istream & buf, JsonBoolean & b );
-    bool   parseLiteral   ( std::istream & buf, JsonType    & item );
 
-    bool   parseAssign    ( std::istream & buf );
-    bool   parseSeparator ( std::istream & buf );
+  private:
 
-    void   setError       ( std::istream & buf );
+    friend class JsonPushParser;
 
-    static
-    json_t ParseValueType ( std::istream & buf );
+    bool   parseDocument ( std::string_view str, bool clear, bool indexed,
+                           const JsonProjection * proj = nullptr );
+    void   dispose();
+    void   take ( JSON & json );
 
   private:
 
-    JsonObject          _root;
-    std::ios::pos_type  _errpos;
-    std::ios::pos_type  _errlen;
-    std::string         _errstr;
+    JsonType *                   _root;
+    JsonArena *                  _arena;
+    std::pmr::memory_resource *  _mr;
+    bool                         _utf8;
+    JsonIndex                    _index;
+    JsonTreeBuilder              _builder;
+    JsonParser<JsonTreeBuilder>  _parser;
+    size_t                       _errpos;
+    std::string                  _errstr;
 };
 
 } // namespace
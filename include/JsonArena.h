@@ -0,0 +1,158 @@
+/**
+  * @file JsonArena.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONARENA_H_
+#define _TCAJSON_JSONARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "JsonType.hpp"
+
+
+namespace tcajson {
+
+
+#ifndef TCAJSON_ARENA_BLOCKSZ
+# define TCAJSON_ARENA_BLOCKSZ   (64 * 1024)
+#endif
+
+#ifndef TCAJSON_ARENA_MAXBLOCKSZ
+# define TCAJSON_ARENA_MAXBLOCKSZ  (16 * 1024 * 1024)
+#endif
+
+
+/** The JsonArena class is a monotonic memory resource for the values
+  * of a document. Memory is bump-allocated from large blocks and never
+  * freed individually; release() frees everything at once, keeping a
+  * single block of the total capacity for the next document so that
+  * repeated documents of a similar size allocate nothing once warm.
+  * Blocks start at TCAJSON_ARENA_BLOCKSZ and double up to
+  * TCAJSON_ARENA_MAXBLOCKSZ.
+  *
+  * Values are created with create(), which constructs the JsonObject,
+  * JsonArray and JsonString types with the arena as their allocator, so
+  * that their members, keys and string payloads are allocated from the
+  * arena as well. Releasing the arena destroys none of them, so values
+  * allocated elsewhere must not be reachable only through arena memory;
+  * inserting such a value into an arena container marks the arena as
+  * having adopted() values, which the owner must then delete first.
+ **/
+class JsonArena : public std::pmr::memory_resource {
+
+  public:
+
+    explicit JsonArena ( size_t blocksz = TCAJSON_ARENA_BLOCKSZ );
+
+    virtual ~JsonArena();
+
+    JsonArena ( const JsonArena & ) = delete;
+    JsonArena& operator= ( const JsonArena & ) = delete;
+
+    template <typename T, typename... Args>
+    T*       create ( Args &&... args );
+
+    void     release();
+    void     shrink();
+
+    void     adopt()         { _adopted = true; }
+    bool     adopted() const { return _adopted; }
+
+    /** Bytes allocated since the last release, and bytes held */
+    size_t   getSize()       const { return _size; }
+    size_t   getCapacity()   const { return _capacity; }
+    size_t   getBlockCount() const { return _blocks.size(); }
+
+  protected:
+
+    void*    do_allocate   ( size_t bytes, size_t align ) override;
+    void     do_deallocate ( void *, size_t, size_t ) override {}
+    bool     do_is_equal   ( const std::pmr::memory_resource & mr ) const noexcept override
+    {
+        return this == &mr;
+    }
+
+  private:
+
+    void*    grow ( size_t bytes, size_t align );
+
+    struct Block {
+        char *  data;
+        size_t  size;
+    };
+
+  private:
+
+    std::vector<Block>  _blocks;
+    char *              _pos;
+    char *              _end;
+    size_t              _blocksz;
+    size_t              _size;
+    size_t              _capacity;
+    bool                _adopted;
+};
+
+
+/** Constructs a value of type T in the arena. Types taking an
+  * allocator are given the arena as their allocator.
+ **/
+template <typename T, typename... Args>
+inline T*
+JsonArena::create ( Args &&... args )
+{
+    T * item = (T*) this->allocate(sizeof(T), alignof(T));
+
+    std::uninitialized_construct_using_allocator(item, JsonAllocator(this),
+        std::forward<Args>(args)...);
+
+    ((JsonType*) item)->_arena = true;
+
+    return item;
+}
+
+
+/** Allocates a value of type T, passing the allocator to the types that
+  * take one. The value is itself created in the resource of the
+  * allocator when that is a JsonArena, and with new otherwise.
+ **/
+template <typename T, typename... Args>
+inline T*
+JsonCreate ( const JsonAllocator & alloc, Args &&... args )
+{
+    JsonArena * arena = dynamic_cast<JsonArena*>(alloc.resource());
+
+    if ( arena != nullptr )
+        return arena->create<T>(std::forward<Args>(args)...);
+
+    if constexpr ( std::uses_allocator_v<T, JsonAllocator> )
+        return new T(std::forward<Args>(args)..., alloc);
+    else
+        return new T(std::forward<Args>(args)...);
+}
+
+} // namespace
+
+#endif // _TCAJSON_JSONARENA_H_
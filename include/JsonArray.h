@@ -24,20 +24,33 @@
 #ifndef _TCAJSON_JSONARRAY_H_
 #define _TCAJSON_JSONARRAY_H_
 
-#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <vector>
 
 #include "JsonType.hpp"
+#include "JsonArena.h"
 
 
 namespace tcajson {
 
 
-/** JsonArray represents a one-dimensional array of JsonItems. */
+/** JsonArray represents a one-dimensional array of JsonItems, kept
+  * in contiguous storage that may be reserved ahead of inserting and
+  * viewed as a span. The array storage is drawn from the allocator of
+  * the array, as are the values copied into it by copy construction or
+  * assignment. Moving an array transfers its elements without copying
+  * them when the allocators are equal, and otherwise copies them with
+  * the new allocator; either way the moved-from array is left empty.
+ **/
 class JsonArray : public JsonType {
 
   public:
 
-    typedef std::deque<JsonType*>      ArrayItems;
+    typedef JsonAllocator  allocator_type;
+
+    typedef std::pmr::vector<JsonType*> ArrayItems;
     typedef ArrayItems::iterator       iterator;
     typedef ArrayItems::const_iterator const_iterator;
     typedef ArrayItems::size_type      size_type;
@@ -45,10 +58,15 @@ class JsonArray : public JsonType {
   public:
 
     JsonArray();
+    explicit JsonArray ( const allocator_type & alloc );
     JsonArray ( const JsonArray & ary );
+    JsonArray ( const JsonArray & ary, const allocator_type & alloc );
+    JsonArray ( JsonArray && ary ) noexcept;
+    JsonArray ( JsonArray && ary, const allocator_type & alloc );
     virtual ~JsonArray();
 
     JsonArray&      operator=  ( const JsonArray & ary );
+    JsonArray&      operator=  ( JsonArray && ary );
     JsonType*       operator[] ( size_type index );
     const JsonType* operator[] ( size_type index ) const;
 
@@ -60,22 +78,59 @@ class JsonArray : public JsonType {
 
     iterator        insert ( JsonType * item );
     iterator        insert ( JsonType * item, iterator at );
+    iterator        insert ( std::unique_ptr<JsonType> item );
+
+    template <typename T, typename... Args>
+    T*              emplace ( Args &&... args );
+
     iterator        erase  ( iterator at );
 
     size_t          size()  const { return _items.size(); }
     bool            empty() const { return _items.empty(); }
     void            clear();
 
+    void            reserve ( size_type count ) { _items.reserve(count); }
+    size_t          capacity() const { return _items.capacity(); }
+    void            shrink_to_fit() { _items.shrink_to_fit(); }
+
+    std::span<JsonType*>              items() { return _items; }
+    std::span<const JsonType* const>  items() const
+    {
+        return std::span<const JsonType* const>(_items.data(), _items.size());
+    }
+
     JsonType*       at ( size_type index );
     const JsonType* at ( size_type index ) const;
 
+    allocator_type  get_allocator() const { return _items.get_allocator(); }
+
     virtual std::string toString ( bool asJson = true ) const;
 
+  private:
+
+    void            moveItems ( JsonArray & ary );
+
   private:
 
     ArrayItems     _items;
 };
 
+
+/** Creates a value of type T from the arguments, with the allocator of
+  * the array, and appends it to the array. Returns the value.
+ **/
+template <typename T, typename... Args>
+inline T*
+JsonArray::emplace ( Args &&... args )
+{
+    std::unique_ptr<T>  item(JsonCreate<T>(this->get_allocator(), std::forward<Args>(args)...));
+    T *                 val = item.get();
+
+    this->insert(std::move(item));
+
+    return val;
+}
+
 } // namespace
 
 #endif // _TCAJSON_JSONARRAY_H_
@@ -0,0 +1,95 @@
+/**
+  * @file JsonIndex.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONINDEX_H_
+#define _TCAJSON_JSONINDEX_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace tcajson {
+
+
+/** The JsonIndex class is the first stage of the two-stage parser.
+  * The input is classified 64 bytes at a time into quote, backslash,
+  * whitespace and structural bitmasks, using the best vectorized
+  * kernel supported by the CPU (see JsonKernels). The position of
+  * every structural character outside of a string, every opening
+  * quote, and the first byte of every other value is recorded, along
+  * with the number of elements of every array. The second stage,
+  * JsonParser::parseIndexed() as used by JSON::parseIndexed(), uses
+  * the index to skip the whitespace before each token and to size each
+  * array before its elements are parsed. Strings and numbers are still
+  * scanned by the tokenizer, so the second stage is not yet faster than
+  * the single pass of JsonParser::parse().
+ **/
+class JsonIndex {
+
+  public:
+
+    typedef std::vector<uint32_t>  Positions;
+    typedef Positions::size_type   size_type;
+
+    /* index of the array size, or UINT32_MAX for an object, and the
+     * index of the opening position of each open container */
+    typedef std::vector<std::pair<uint32_t, uint32_t>>  Containers;
+
+  public:
+
+    JsonIndex();
+    ~JsonIndex();
+
+    bool              build ( std::string_view str );
+    void              clear();
+    void              shrink();
+
+    const Positions&  positions()  const { return _positions; }
+    const Positions&  arraySizes() const { return _sizes; }
+
+    size_t            size()  const { return _positions.size(); }
+    bool              empty() const { return _positions.empty(); }
+
+    size_t            getErrorPos() const { return _errpos; }
+
+    static std::string  Implementation();
+
+  private:
+
+    void              countArrays ( const char * p, uint64_t op,
+                                    uint64_t structural, size_type n );
+
+  private:
+
+    Positions       _positions;
+    Positions       _sizes;
+    Containers      _stack;
+    size_t          _errpos;
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONINDEX_H_
@@ -0,0 +1,75 @@
+/**
+  * @file JsonKernels.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONKERNELS_H_
+#define _TCAJSON_JSONKERNELS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace tcajson {
+
+
+/** Bitmasks for one 64 byte block of input, one bit per byte. */
+struct JsonBlockMasks {
+    uint64_t  quote;
+    uint64_t  backslash;
+    uint64_t  space;
+    uint64_t  op;
+};
+
+
+/** The JsonKernels class is a table of the vectorized scanning
+  * functions used by the parser and serializer. One table exists per
+  * instruction set (scalar, sse4.2, avx2 and avx512), and the best
+  * table supported by the running CPU is selected once, at first use,
+  * via cpuid. Select() may be used to force a specific implementation.
+ **/
+class JsonKernels {
+
+  public:
+
+    /** Classifies the 64 bytes at 'p' into the block masks */
+    typedef void         (*ClassifyFn) ( const char * p, JsonBlockMasks & m );
+
+    /** Returns the first matching position in [p, end) or 'end' */
+    typedef const char*  (*ScanFn)     ( const char * p, const char * end );
+
+    const char *   name;
+    ClassifyFn     classify;
+    ScanFn         skipSpace;   // first byte that is not JSON whitespace
+    ScanFn         scanString;  // first quote, backslash or control char
+    ScanFn         validUtf8;   // first byte of an ill-formed UTF-8 sequence
+
+  public:
+
+    static const JsonKernels&        Active();
+    static bool                      Select ( const std::string & name );
+    static std::vector<std::string>  Available();
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONKERNELS_H_
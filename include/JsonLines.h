@@ -0,0 +1,135 @@
+/**
+  * @file JsonLines.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONLINES_H_
+#define _TCAJSON_JSONLINES_H_
+
+#include <chrono>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <string_view>
+
+#include "JSON.h"
+#include "JsonMappedFile.h"
+
+
+namespace tcajson {
+
+
+#ifndef TCAJSON_LINES_BUFSZ
+# define TCAJSON_LINES_BUFSZ  (1024 * 1024)
+#endif
+
+
+/** The JsonLines class reads newline-delimited JSON (NDJSON or JSON
+  * Lines), one document per line, from a buffer, a file or an input
+  * stream. Each call to next() parses the following record into the
+  * same JSON document, so the root and the input buffer are reused
+  * from one record to the next. A malformed line does not end the
+  * stream; next() still returns true with valid() false and the error
+  * of that line available. Empty lines are skipped. Files are memory
+  * mapped and read in place where possible. Streams are read in blocks
+  * of TCAJSON_LINES_BUFSZ bytes, growing only for longer lines.
+  *
+  *   JsonLines  reader;
+  *   reader.open("events.ndjson");
+  *   while ( reader.next() ) {
+  *       if ( ! reader.valid() )
+  *           continue;  // reader.getLineNumber(), reader.getErrorStr()
+  *       JsonObject & rec = reader.getJSON();
+  *   }
+ **/
+class JsonLines {
+
+  public:
+
+    typedef std::chrono::steady_clock  clock_type;
+
+  public:
+
+    JsonLines();
+    explicit JsonLines ( std::string_view buf );
+    explicit JsonLines ( std::istream   & strm );
+
+    ~JsonLines();
+
+    bool            open   ( const std::string & filename );
+    void            assign ( std::string_view buf );
+    void            assign ( std::istream   & strm );
+    void            close();
+
+    bool            next();
+    bool            valid() const  { return _valid; }
+
+    /** Returns the current record */
+    JSON&           getDocument()  { return _json; }
+    JsonType*       getRoot()      { return _json.getRoot(); }
+    JsonObject&     getJSON()      { return _json.getJSON(); }
+
+    /** Returns the text of the current line */
+    std::string_view  getLine()    const { return _line; }
+    size_t          getLineNumber() const { return _lineno; }
+
+    size_t          getErrorPos()  const { return _json.getErrorPos(); }
+    std::string     getErrorStr()  const { return _json.getErrorStr(); }
+
+    void            setValidateUtf8 ( bool validate );
+
+    /** Counts of the records read, of which getErrorCount() failed */
+    size_t          getRecordCount() const { return _records; }
+    size_t          getErrorCount()  const { return _errors; }
+    size_t          getByteCount()   const { return _bytes; }
+
+    double          getElapsed()       const;
+    double          getRecordsPerSec() const;
+    double          getBytesPerSec()   const;
+
+    void            resetStats();
+
+  private:
+
+    bool            nextLine();
+    bool            fill();
+
+  private:
+
+    JSON                  _json;
+    JsonMappedFile        _map;
+    std::ifstream         _file;
+    std::istream *        _strm;
+    std::string           _buf;
+    std::string_view      _data;
+    size_t                _off;
+    std::string_view      _line;
+    bool                  _valid;
+    size_t                _lineno;
+    size_t                _records;
+    size_t                _errors;
+    size_t                _bytes;
+    clock_type::duration  _elapsed;
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONLINES_H_
@@ -24,7 +24,12 @@
 #ifndef _TCAJSON_JSONLITERAL_HPP_
 #define _TCAJSON_JSONLITERAL_HPP_
 
+#include <cstdint>
+#include <memory_resource>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
 
 #include "JsonType.hpp"
 
@@ -47,6 +52,11 @@ class JsonLiteral : public JsonType {
           _value(val)
     {}
 
+    JsonLiteral ( T && val, json_t  t = JSON_NULL )
+        : JsonType(t),
+          _value(std::move(val))
+    {}
+
     virtual ~JsonLiteral() {}
 
 
@@ -93,18 +103,40 @@ class JsonLiteral : public JsonType {
 };
 
 
+/** Returns the given string with quotes, backslashes and control
+  * characters escaped for output as a JSON string value.
+ **/
+std::string  JsonEscape ( std::string_view str );
+
+
 /** The JsonString class represents all of our JSON string objects.
   * Note that the default value for the toString() 'asJson' parameter
   * here is false.  Calling ::toString() directly on a JsonString
   * defaults the behavior to returning only the string value with no
   * quotes.  The toString() method of a JsonObject will explitly call
   * this method with 'asJson' as true to ensure that the resulting
-  * output is properly formatted JSON.
+  * output is properly formatted JSON. The value is held in a
+  * std::pmr::string, drawn from the allocator the string is
+  * constructed with.
  **/
-class JsonString : public JsonLiteral<std::string> {
+class JsonString : public JsonLiteral<std::pmr::string> {
   public:
+    typedef JsonAllocator  allocator_type;
+
     JsonString ( const std::string & val = std::string(), json_t  t = JSON_STRING )
-        : JsonLiteral<std::string>(val, t)
+        : JsonLiteral<std::pmr::string>(std::pmr::string(val), t)
+    {}
+
+    explicit JsonString ( const allocator_type & alloc )
+        : JsonLiteral<std::pmr::string>(std::pmr::string(alloc), JSON_STRING)
+    {}
+
+    JsonString ( std::string_view val, const allocator_type & alloc )
+        : JsonLiteral<std::pmr::string>(std::pmr::string(val, alloc), JSON_STRING)
+    {}
+
+    JsonString ( const JsonString & str, const allocator_type & alloc )
+        : JsonLiteral<std::pmr::string>(std::pmr::string(str.value(), alloc), str.getType())
     {}
 
     virtual ~JsonString() {}
@@ -114,28 +146,104 @@ class JsonString : public JsonLiteral<std::string> {
         std::stringstream jstr;
 
         if ( asJson )
-            jstr << TOKEN_STRING_SEPARATOR;
-
-        jstr << this->value();
-
-        if ( asJson )
-            jstr << TOKEN_STRING_SEPARATOR;
+            jstr << TOKEN_STRING_SEPARATOR << JsonEscape(this->value())
+                 << TOKEN_STRING_SEPARATOR;
+        else
+            jstr << this->value();
 
         return jstr.str();
     }
 };
 
 
+/**  JsonNumberType identifies the representation held by a JsonNumber */
+typedef enum JsonNumberType {
+    JSON_NUMBER_DOUBLE,
+    JSON_NUMBER_INT64,
+    JSON_NUMBER_UINT64
+} jnum_t;
+
+
 /**  The JsonNumber class represents a number as a double. We use a double as
   *  a catch all type that can support any number format, though
   *  specializations for JsonInteger and JsonLong allow for more specific types.
+  *  A JsonNumber may additionally hold an exact 64-bit integer, which is
+  *  how the parser stores any number without a fraction or exponent. The
+  *  double value() of an integer is kept as the nearest approximation, while
+  *  getInteger() and getUnsigned() return the exact value. The value()
+  *  of a number is read only, and is written with setDouble(), setInteger()
+  *  or setUnsigned() so that the representation always follows the value.
  **/
 class JsonNumber : public JsonLiteral<double> {
   public:
     JsonNumber ( double val = 0.0, json_t t = JSON_NUMBER )
-        : JsonLiteral<double>(val, t)
+        : JsonLiteral<double>(val, t),
+          _int(0),
+          _ntype(JSON_NUMBER_DOUBLE)
     {}
     virtual ~JsonNumber() {}
+
+    /** The value is read only, being written with the setters below */
+    operator double&() = delete;
+    operator const double&() const { return this->value(); }
+
+    const double& value() const { return JsonLiteral<double>::value(); }
+
+    jnum_t   getNumberType() const { return this->_ntype; }
+    bool     isInteger()     const { return this->_ntype != JSON_NUMBER_DOUBLE; }
+    bool     isUnsigned()    const { return this->_ntype == JSON_NUMBER_UINT64; }
+
+    void     setDouble ( double val )
+    {
+        JsonLiteral<double>::value() = val;
+        this->_int                   = 0;
+        this->_ntype                 = JSON_NUMBER_DOUBLE;
+    }
+
+    void     setInteger ( int64_t val )
+    {
+        JsonLiteral<double>::value() = static_cast<double>(val);
+        this->_int                   = static_cast<uint64_t>(val);
+        this->_ntype                 = JSON_NUMBER_INT64;
+    }
+
+    void     setUnsigned ( uint64_t val )
+    {
+        JsonLiteral<double>::value() = static_cast<double>(val);
+        this->_int                   = val;
+        this->_ntype                 = (val > static_cast<uint64_t>(INT64_MAX))
+                                     ? JSON_NUMBER_UINT64 : JSON_NUMBER_INT64;
+    }
+
+    /** Returns the value as a signed integer, truncating a double */
+    int64_t  getInteger() const
+    {
+        if ( this->isInteger() )
+            return static_cast<int64_t>(this->_int);
+        return static_cast<int64_t>(this->value());
+    }
+
+    /** Returns the value as an unsigned integer, truncating a double */
+    uint64_t getUnsigned() const
+    {
+        if ( this->isInteger() )
+            return this->_int;
+        return static_cast<uint64_t>(this->value());
+    }
+
+    virtual std::string toString ( bool asJson = true ) const
+    {
+        if ( this->_ntype == JSON_NUMBER_INT64 )
+            return std::to_string(static_cast<int64_t>(this->_int));
+        if ( this->_ntype == JSON_NUMBER_UINT64 )
+            return std::to_string(this->_int);
+        return JsonLiteral<double>::toString(asJson);
+    }
+
+  private:
+
+    uint64_t  _int;
+    jnum_t    _ntype;
 };
 
 
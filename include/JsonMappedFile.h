@@ -0,0 +1,74 @@
+/**
+  * @file JsonMappedFile.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONMAPPEDFILE_H_
+#define _TCAJSON_JSONMAPPEDFILE_H_
+
+#include <string>
+#include <string_view>
+
+
+namespace tcajson {
+
+
+/** The JsonMappedFile class maps a file read-only into memory so that
+  * it may be parsed in place, without reading it through a stream or
+  * copying it into a buffer. The mapping is advised for sequential
+  * access with read-ahead of the whole file, and is released by close()
+  * or on destruction, after which any views of it are invalid. An empty
+  * file maps to an empty view.
+ **/
+class JsonMappedFile {
+
+  public:
+
+    JsonMappedFile();
+    explicit JsonMappedFile ( const std::string & filename ) noexcept(false);
+
+    ~JsonMappedFile();
+
+    JsonMappedFile ( const JsonMappedFile & ) = delete;
+    JsonMappedFile& operator= ( const JsonMappedFile & ) = delete;
+
+    bool              open ( const std::string & filename );
+    void              close();
+
+    bool              isOpen() const { return _open; }
+
+    const char*       data()   const { return _addr; }
+    size_t            size()   const { return _size; }
+    std::string_view  view()   const { return std::string_view(_addr, _size); }
+
+    std::string       getErrorStr() const { return _errstr; }
+
+  private:
+
+    const char *  _addr;
+    size_t        _size;
+    bool          _open;
+    std::string   _errstr;
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONMAPPEDFILE_H_
@@ -24,24 +24,60 @@
 #ifndef _TCAJSON_JSONOBJECT_H_
 #define _TCAJSON_JSONOBJECT_H_
 
-#include <map>
+#include <cstdint>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "JsonType.hpp"
+#include "JsonArena.h"
 
 
 namespace tcajson {
 
 
+#ifndef TCAJSON_OBJECT_INDEXSZ
+# define TCAJSON_OBJECT_INDEXSZ  8
+#endif
+
+
 /** The JsonObject class represents the core JSON type of
-  * an associative array. The STL map container is used
-  * as the underlying container.
+  * an associative array. Members are kept in insertion
+  * order in a contiguous vector of key and value pairs,
+  * which small objects search linearly. Once an object
+  * holds more than TCAJSON_OBJECT_INDEXSZ members, a hash
+  * index of the keys is maintained as members are inserted
+  * and erased, so that lookups only read the object and a
+  * const object may be searched from several threads at
+  * once. Keys are looked up as
+  * string_views without being copied, and the members and
+  * keys are drawn from the allocator of the object.
+  * Values copied into an object, by copy construction or
+  * assignment, use the allocator of the object as well.
+  * Moving an object transfers its members without copying
+  * them when the allocators are equal, and otherwise copies
+  * them with the new allocator; either way the moved-from
+  * object is left empty.
+  * The key of a member, the first of each value_type, is a
+  * std::pmr::string drawn from that allocator, and so does
+  * not bind to a 'const std::string &'. Iterating code should
+  * take the key as a std::string_view, or construct a
+  * std::string from it explicitly. The key of a member must
+  * not be modified in place.
  **/
 class JsonObject : public JsonType {
 
   public:
 
-    typedef std::map<std::string, JsonType*> JsonItems;
+    typedef JsonAllocator  allocator_type;
+
+    /** The key is a std::pmr::string, not a std::string */
+    typedef std::pair<std::pmr::string, JsonType*>  value_type;
+    typedef std::pmr::vector<value_type>     JsonItems;
     typedef JsonItems::iterator              iterator;
     typedef JsonItems::const_iterator        const_iterator;
     typedef std::pair<iterator, bool>        pairI;
@@ -50,15 +86,26 @@ class JsonObject : public JsonType {
   public:
 
     JsonObject();
+    explicit JsonObject ( const allocator_type & alloc );
     JsonObject ( const JsonObject & obj );
+    JsonObject ( const JsonObject & obj, const allocator_type & alloc );
+    JsonObject ( JsonObject && obj ) noexcept;
+    JsonObject ( JsonObject && obj, const allocator_type & alloc );
 
     virtual ~JsonObject();
 
     JsonObject&     operator=  ( const JsonObject  & obj );
-    JsonType*       operator[] ( const std::string & key );
-    const JsonType* operator[] ( const std::string & key ) const;
+    JsonObject&     operator=  ( JsonObject && obj );
+    JsonType*       operator[] ( std::string_view key );
+    const JsonType* operator[] ( std::string_view key ) const;
+
+    pairI           insert ( std::string_view key, JsonType * item )
+                      noexcept(false);
+    pairI           insert ( std::string_view key, std::unique_ptr<JsonType> item )
+                      noexcept(false);
 
-    pairI           insert ( const std::string & key, JsonType * item )
+    template <typename T, typename... Args>
+    T*              emplace ( std::string_view key, Args &&... args )
                       noexcept(false);
 
     iterator        begin() { return _items.begin(); }
@@ -69,25 +116,53 @@ class JsonObject : public JsonType {
 
     iterator        erase  ( iterator at );
     iterator        erase  ( iterator first, iterator last );
-    size_type       erase  ( const std::string & key );
+    size_type       erase  ( std::string_view key );
 
-    iterator        find   ( const std::string & key );
-    const_iterator  find   ( const std::string & key ) const;
-    bool            exists ( const std::string & key ) const;
+    iterator        find   ( std::string_view key );
+    const_iterator  find   ( std::string_view key ) const;
+    bool            exists ( std::string_view key ) const;
 
     size_t          size()  const { return _items.size(); }
     bool            empty() const { return _items.empty(); }
     void            clear();
 
+    allocator_type  get_allocator() const { return _items.get_allocator(); }
+
     virtual 
     std::string     toString ( bool asJson = true ) const;
 
 
   protected:
 
-    JsonItems      _items;
+    size_t          indexOf     ( std::string_view key ) const;
+    void            buildIndex();
+    void            indexAdd    ( uint32_t pos );
+    void            indexRemove ( size_t pos, size_t count );
+    void            moveItems   ( JsonObject & obj );
+
+  protected:
+
+    JsonItems                          _items;
+    std::pmr::vector<uint32_t>         _index;
 };
 
+
+/** Creates a value of type T from the arguments, with the allocator of
+  * the object, and inserts it with the given key. Returns the value, or
+  * throws a runtime_error if the key already exists.
+ **/
+template <typename T, typename... Args>
+inline T*
+JsonObject::emplace ( std::string_view key, Args &&... args )
+{
+    std::unique_ptr<T>  item(JsonCreate<T>(this->get_allocator(), std::forward<Args>(args)...));
+    T *                 val = item.get();
+
+    this->insert(key, std::move(item));
+
+    return val;
+}
+
 } // namespace
 
 #endif // _TCAJSON_JSONOBJECT_H_
@@ -0,0 +1,532 @@
+/**
+  * @file JsonParser.hpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONPARSER_HPP_
+#define _TCAJSON_JSONPARSER_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+#include "JsonTokenizer.h"
+#include "JsonProjection.h"
+
+
+namespace tcajson {
+
+
+/** The JsonHandler class defines the events of the JsonParser. A
+  * handler provides any of these methods, hiding the defaults which
+  * accept and ignore the event. Every event returns true to continue
+  * or false to stop the parse, which then fails with an error at the
+  * current position. Strings and keys are views that are only valid
+  * for the duration of the call. Numbers are delivered as integer() for
+  * integers that fit an int64_t, uinteger() for larger integers that
+  * fit a uint64_t, and number() for all others. When parsing from a
+  * JsonIndex, startArray() is followed by arraySize() with the number
+  * of elements the array holds.
+ **/
+class JsonHandler {
+
+  public:
+
+    bool  startObject()                  { return true; }
+    bool  endObject()                    { return true; }
+    bool  startArray()                   { return true; }
+    bool  endArray()                     { return true; }
+    bool  arraySize ( size_t )           { return true; }
+    bool  key      ( std::string_view )  { return true; }
+    bool  string   ( std::string_view )  { return true; }
+    bool  integer  ( int64_t )           { return true; }
+    bool  uinteger ( uint64_t )          { return true; }
+    bool  number   ( double )            { return true; }
+    bool  boolean  ( bool )              { return true; }
+    bool  null()                         { return true; }
+};
+
+
+/** The JsonParser class is the event-driven parser of the library.
+  * It walks the structure of a document with the JsonTokenizer and
+  * reports each value to the Handler as it is parsed, without building
+  * a tree or allocating per value. The Handler is a template parameter
+  * so that its events are resolved, and typically inlined, at compile
+  * time. The JSON class builds its tree with a JsonTreeBuilder handler,
+  * and any other handler may compute results directly from the events.
+ **/
+template <typename Handler>
+class JsonParser : public JsonTokenizer {
+
+  public:
+
+    explicit JsonParser ( Handler & handler )
+        : _handler(handler)
+    {}
+
+    ~JsonParser() {}
+
+    bool      parse          ( std::string_view str );
+    bool      parseIndexed   ( std::string_view str, JsonIndex & index );
+    bool      parseProjected ( std::string_view str, const JsonProjection & proj );
+    bool      parseValue();
+
+    Handler&  getHandler() { return _handler; }
+
+  private:
+
+    bool      parseDocument ( const JsonProjection * proj = nullptr );
+    bool      parseObject();
+    bool      parseArray();
+
+    bool      projectValue  ( const JsonProjection & proj, uint32_t node );
+    bool      projectObject ( const JsonProjection & proj, uint32_t node );
+    bool      projectArray  ( const JsonProjection & proj, uint32_t node );
+
+  private:
+
+    Handler &  _handler;
+};
+
+// ------------------------------------------------------------------------- //
+
+/** Parses the given string as a complete document. Only whitespace,
+  * and a leading UTF-8 byte order mark, may surround the root value.
+ **/
+template <typename Handler>
+inline bool
+JsonParser<Handler>::parse ( std::string_view str )
+{
+    this->reset(str);
+
+    return this->parseDocument();
+}
+
+
+/** Parses the given string as a complete document using the two-stage
+  * parser, building the structural index into 'index' first.
+ **/
+template <typename Handler>
+inline bool
+JsonParser<Handler>::parseIndexed ( std::string_view str, JsonIndex & index )
+{
+    bool  p;
+
+    this->reset(str);
+
+    if ( ! index.build(str) ) {
+        _pos = _beg + index.getErrorPos();
+        return this->setError();
+    }
+
+    this->setIndex(&index);
+
+    p = this->parseDocument();
+
+    this->setIndex(nullptr);
+
+    return p;
+}
+
+
+/** Parses the given string as a complete document, reporting only the
+  * values selected by the projection along with the containers that
+  * enclose them. All other values are skipped without being converted,
+  * so their contents are not fully validated.
+ **/
+template <typename Handler>
+inline bool
+JsonParser<Handler>::parseProjected ( std::string_view str, const JsonProjection & proj )
+{
+    this->reset(str);
+
+    return this->parseDocument(&proj);
+}
+
+
+template <typename Handler>
+inline bool
+JsonParser<Handler>::parseDocument ( const JsonProjection * proj )
+{
+    bool  p;
+
+    if ( _end - _pos >= 3 && std::string_view(_pos, 3) == "\xEF\xBB\xBF" )
+        _pos += 3;  // byte order mark
+
+    this->skipSpace();
+
+    if ( _pos == _end )
+        return this->setError();
+
+    if ( proj != nullptr )
+        p = this->projectValue(*proj, 0);
+    else
+        p = this->parseValue();
+
+    if ( ! p )
+        return false;
+
+    this->skipSpace();
+
+    if ( _pos != _end )
+        return this->setError();  // trailing text
+
+    return true;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Parses the next value from the current position, reporting it to
+  * the handler. Containers are parsed recursively.
+ **/
+template <typename Handler>
+inline bool
+JsonParser<Handler>::parseValue()
+{
+    this->skipSpace();
+
+    if ( _pos == _end )
+        return this->setError();
+
+    switch ( *_pos )
+    {
+        case TOKEN_OBJECT_BEGIN:
+            return this->parseObject();
+
+        case TOKEN_ARRAY_BEGIN:
+            return this->parseArray();
+
+        case TOKEN_STRING_SEPARATOR: {
+            std::string_view  str;
+            if ( ! this->parseString(str) )
+                return false;
+            if ( ! _handler.string(str) )
+                return this->setError();
+            break;
+        }
+
+        case 't':
+        case 'f': {
+            bool  b;
+            if ( ! this->parseBoolean(b) )
+                return false;
+            if ( ! _handler.boolean(b) )
+                return this->setError();
+            break;
+        }
+
+        case 'n':
+            if ( ! this->parseNull() )
+                return false;
+            if ( ! _handler.null() )
+                return this->setError();
+            break;
+
+        default: {
+            jnum_t    ntype;
+            uint64_t  ival;
+            double    val;
+            bool      r;
+
+            if ( ! this->parseNumber(ntype, ival, val) )
+                return false;
+
+            switch ( ntype ) {
+                case JSON_NUMBER_INT64:
+                    r = _handler.integer(static_cast<int64_t>(ival));
+                    break;
+                case JSON_NUMBER_UINT64:
+                    r = _handler.uinteger(ival);
+                    break;
+                default:
+                    r = _handler.number(val);
+                    break;
+            }
+
+            if ( ! r )
+                return this->setError();
+            break;
+        }
+    }
+
+    return true;
+}
+
+
+template <typename Handler>
+inline bool
+JsonParser<Handler>::parseObject()
+{
+    std::string_view  key;
+
+    ++_pos;
+
+    if ( ! _handler.startObject() )
+        return this->setError();
+
+    this->skipSpace();
+
+    if ( _pos < _end && *_pos == TOKEN_OBJECT_END ) {
+        ++_pos;
+        return _handler.endObject() || this->setError();
+    }
+
+    while ( true )
+    {
+        // key
+        this->skipSpace();
+
+        if ( ! this->parseString(key) )
+            return false;
+
+        if ( ! _handler.key(key) )
+            return this->setError();
+
+        this->skipSpace();
+
+        if ( _pos == _end || *_pos != TOKEN_NAME_SEPARATOR )
+            return this->setError();
+
+        ++_pos;
+
+        // val
+        if ( ! this->parseValue() )
+            return false;
+
+        this->skipSpace();
+
+        if ( _pos == _end )
+            break;
+
+        if ( *_pos == TOKEN_OBJECT_END ) {
+            ++_pos;
+            return _handler.endObject() || this->setError();
+        }
+
+        if ( *_pos != TOKEN_VALUE_SEPARATOR )
+            break;
+
+        ++_pos;
+    }
+
+    return this->setError();
+}
+
+
+template <typename Handler>
+inline bool
+JsonParser<Handler>::parseArray()
+{
+    size_t  count;
+
+    ++_pos;
+
+    if ( ! _handler.startArray() )
+        return this->setError();
+
+    if ( this->nextArraySize(count) && ! _handler.arraySize(count) )
+        return this->setError();
+
+    this->skipSpace();
+
+    if ( _pos < _end && *_pos == TOKEN_ARRAY_END ) {
+        ++_pos;
+        return _handler.endArray() || this->setError();
+    }
+
+    while ( true )
+    {
+        if ( ! this->parseValue() )
+            return false;
+
+        this->skipSpace();
+
+        if ( _pos == _end )
+            break;
+
+        if ( *_pos == TOKEN_ARRAY_END ) {
+            ++_pos;
+            return _handler.endArray() || this->setError();
+        }
+
+        if ( *_pos != TOKEN_VALUE_SEPARATOR )
+            break;
+
+        ++_pos;
+    }
+
+    return this->setError();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Parses the value at the given projection node. A kept value is
+  * parsed in full, a container is descended into, and anything else
+  * is skipped.
+ **/
+template <typename Handler>
+inline bool
+JsonParser<Handler>::projectValue ( const JsonProjection & proj, uint32_t node )
+{
+    this->skipSpace();
+
+    if ( _pos == _end )
+        return this->setError();
+
+    if ( proj.keep(node) )
+        return this->parseValue();
+
+    if ( *_pos == TOKEN_OBJECT_BEGIN )
+        return this->projectObject(proj, node);
+
+    if ( *_pos == TOKEN_ARRAY_BEGIN )
+        return this->projectArray(proj, node);
+
+    return this->skipValue();
+}
+
+
+/** Parses an object along a projected path. Members with a selected
+  * key are reported, unless the path continues below a value that is
+  * not a container, and all other members are skipped.
+ **/
+template <typename Handler>
+inline bool
+JsonParser<Handler>::projectObject ( const JsonProjection & proj, uint32_t node )
+{
+    std::string_view  key;
+    uint32_t          child;
+
+    ++_pos;
+
+    if ( ! _handler.startObject() )
+        return this->setError();
+
+    this->skipSpace();
+
+    if ( _pos < _end && *_pos == TOKEN_OBJECT_END ) {
+        ++_pos;
+        return _handler.endObject() || this->setError();
+    }
+
+    while ( true )
+    {
+        this->skipSpace();
+
+        if ( ! this->parseString(key) )
+            return false;
+
+        child = proj.find(node, key);
+
+        this->skipSpace();
+
+        if ( _pos == _end || *_pos != TOKEN_NAME_SEPARATOR )
+            return this->setError();
+
+        ++_pos;
+        this->skipSpace();
+
+        if ( child != JsonProjection::npos && _pos < _end &&
+             (proj.keep(child) || *_pos == TOKEN_OBJECT_BEGIN || *_pos == TOKEN_ARRAY_BEGIN) )
+        {
+            if ( ! _handler.key(key) )
+                return this->setError();
+            if ( ! this->projectValue(proj, child) )
+                return false;
+        }
+        else if ( ! this->skipValue() )
+        {
+            return false;
+        }
+
+        this->skipSpace();
+
+        if ( _pos == _end )
+            break;
+
+        if ( *_pos == TOKEN_OBJECT_END ) {
+            ++_pos;
+            return _handler.endObject() || this->setError();
+        }
+
+        if ( *_pos != TOKEN_VALUE_SEPARATOR )
+            break;
+
+        ++_pos;
+    }
+
+    return this->setError();
+}
+
+
+/** Parses an array along a projected path, projecting each element
+  * with the same node. Elements that are not containers are skipped.
+ **/
+template <typename Handler>
+inline bool
+JsonParser<Handler>::projectArray ( const JsonProjection & proj, uint32_t node )
+{
+    ++_pos;
+
+    if ( ! _handler.startArray() )
+        return this->setError();
+
+    this->skipSpace();
+
+    if ( _pos < _end && *_pos == TOKEN_ARRAY_END ) {
+        ++_pos;
+        return _handler.endArray() || this->setError();
+    }
+
+    while ( true )
+    {
+        this->skipSpace();
+
+        if ( _pos < _end && (*_pos == TOKEN_OBJECT_BEGIN || *_pos == TOKEN_ARRAY_BEGIN) ) {
+            if ( ! this->projectValue(proj, node) )
+                return false;
+        } else if ( ! this->skipValue() ) {
+            return false;
+        }
+
+        this->skipSpace();
+
+        if ( _pos == _end )
+            break;
+
+        if ( *_pos == TOKEN_ARRAY_END ) {
+            ++_pos;
+            return _handler.endArray() || this->setError();
+        }
+
+        if ( *_pos != TOKEN_VALUE_SEPARATOR )
+            break;
+
+        ++_pos;
+    }
+
+    return this->setError();
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+#endif // _TCAJSON_JSONPARSER_HPP_
@@ -0,0 +1,120 @@
+/**
+  * @file JsonPipeline.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONPIPELINE_H_
+#define _TCAJSON_JSONPIPELINE_H_
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "JSON.h"
+
+
+namespace tcajson {
+
+
+#define TCAJSON_PIPELINE_CHUNKSZ  (1024 * 1024)
+
+
+/** A record delivered by the JsonPipeline to its consumer. */
+struct JsonRecord {
+    JSON *            doc;     // the parsed document, reused after delivery
+    std::string_view  line;    // the text of the record
+    size_t            offset;  // byte offset of the line within the input
+    size_t            lineno;  // line number, in ordered mode only
+    bool              valid;   // false if the line failed to parse
+};
+
+
+/** The JsonPipeline class parses newline-delimited JSON in parallel.
+  * The input buffer, or memory mapped file, is split into chunks of
+  * about TCAJSON_PIPELINE_CHUNKSZ bytes at newline boundaries, and the
+  * chunks are parsed by a pool of worker threads. Each worker owns a
+  * queue of chunks and steals from the other queues once its own is
+  * empty, so regions of long or slow lines are balanced across the
+  * pool.
+  *
+  * In ordered mode, records are delivered to the consumer in input
+  * order from the calling thread, and the workers run at most a fixed
+  * window of chunks ahead of the consumer. In unordered mode, each
+  * worker calls the consumer directly as records are parsed, so the
+  * consumer must be thread-safe, and line numbers are not known. In
+  * both modes the record and its document are only valid for the
+  * duration of the call, and the consumer must not throw.
+ **/
+class JsonPipeline {
+
+  public:
+
+    typedef std::function<void ( JsonRecord & rec )>  Consumer;
+    typedef std::chrono::steady_clock                 clock_type;
+
+  public:
+
+    explicit JsonPipeline ( size_t threads = 0, bool ordered = true );
+
+    ~JsonPipeline();
+
+    bool            run     ( std::string_view buf, Consumer consumer );
+    bool            runFile ( const std::string & filename, Consumer consumer );
+
+    void            setThreads   ( size_t threads );
+    size_t          getThreads() const    { return _threads; }
+
+    void            setOrdered   ( bool ordered ) { _ordered = ordered; }
+    bool            getOrdered() const    { return _ordered; }
+
+    void            setChunkSize ( size_t sz );
+    size_t          getChunkSize() const  { return _chunksz; }
+
+    void            setValidateUtf8 ( bool validate ) { _utf8 = validate; }
+
+    /** Statistics of the last run */
+    size_t          getRecordCount() const { return _records; }
+    size_t          getErrorCount()  const { return _errors; }
+    size_t          getByteCount()   const { return _bytes; }
+
+    double          getElapsed()       const;
+    double          getRecordsPerSec() const;
+    double          getBytesPerSec()   const;
+
+    std::string     getErrorStr() const   { return _errstr; }
+
+  private:
+
+    size_t                _threads;
+    bool                  _ordered;
+    bool                  _utf8;
+    size_t                _chunksz;
+    size_t                _records;
+    size_t                _errors;
+    size_t                _bytes;
+    clock_type::duration  _elapsed;
+    std::string           _errstr;
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONPIPELINE_H_
@@ -0,0 +1,96 @@
+/**
+  * @file JsonProjection.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONPROJECTION_H_
+#define _TCAJSON_JSONPROJECTION_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace tcajson {
+
+
+/** The JsonProjection class is a set of key paths selecting the parts
+  * of a document to keep, for JSON::parse() and JsonParser to build or
+  * report while skipping everything else. Paths use the JSON Pointer
+  * syntax of RFC 6901, such as "/src_ip" or "/route/aspath", with '~1'
+  * and '~0' escaping '/' and '~' within a key, and the empty path ""
+  * selecting the whole document. The whole value at the end of a path
+  * is kept. Arrays along a path are transparent: the keys below an
+  * array are selected from each of its elements.
+  *
+  * The paths are compiled once into a trie, so a projection may be
+  * reused for any number of documents.
+ **/
+class JsonProjection {
+
+  public:
+
+    static const uint32_t  npos = UINT32_MAX;
+
+  public:
+
+    JsonProjection();
+    explicit JsonProjection ( const std::vector<std::string> & paths ) noexcept(false);
+
+    ~JsonProjection();
+
+    bool        add ( std::string_view path );
+    void        clear();
+
+    size_t      size()  const { return _paths; }
+    bool        empty() const { return _paths == 0; }
+
+    /** Returns true if the whole value at the given node is kept */
+    bool        keep ( uint32_t node ) const { return _nodes[node].keep; }
+
+    /** Returns the child of 'node' for the given key, or npos */
+    uint32_t    find ( uint32_t node, std::string_view key ) const
+    {
+        for ( const Child & c : _nodes[node].children ) {
+            if ( c.first == key )
+                return c.second;
+        }
+        return npos;
+    }
+
+  private:
+
+    typedef std::pair<std::string, uint32_t>  Child;
+
+    struct Node {
+        bool                keep;
+        std::vector<Child>  children;
+    };
+
+    std::vector<Node>   _nodes;
+    size_t              _paths;
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONPROJECTION_H_
@@ -0,0 +1,140 @@
+/**
+  * @file JsonPushParser.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONPUSHPARSER_H_
+#define _TCAJSON_JSONPUSHPARSER_H_
+
+#include <string>
+#include <vector>
+
+#include "JSON.h"
+
+
+namespace tcajson {
+
+
+/**  The result of feeding input to the JsonPushParser */
+typedef enum JsonFeedStatus {
+    JSON_FEED_NEED_MORE,
+    JSON_FEED_COMPLETE,
+    JSON_FEED_ERROR
+} jfeed_t;
+
+
+/** The JsonPushParser class is a resumable parser for documents that
+  * arrive in arbitrary fragments, such as from a socket. Each call to
+  * feed() consumes the given bytes and returns JSON_FEED_NEED_MORE
+  * until the root value is complete. The structure of the document is
+  * tracked on an explicit stack, so the parser never needs the whole
+  * document in memory. Only a token split across two fragments is
+  * carried over, and tokens complete within a fragment are parsed in
+  * place by a JsonParser with the JsonTreeBuilder. Containers are
+  * attached to the tree as they open, so the tree is built incrementally
+  * and is identical to that of JSON::parse.
+  *
+  * A root value that ends without a closing delimiter, such as a bare
+  * number, completes only at finish(). Once complete, the document is
+  * available via getDocument(), getConsumed() reports the bytes of the
+  * last fragment that belonged to it, and reset() prepares the parser
+  * for the next document.
+ **/
+class JsonPushParser {
+
+  public:
+
+    JsonPushParser();
+    ~JsonPushParser();
+
+    jfeed_t         feed   ( const char * buf, size_t len );
+    jfeed_t         finish();
+    void            reset();
+
+    bool            complete() const   { return _state == PUSH_DONE; }
+
+    /** Returns the parsed document, once complete */
+    JSON&           getDocument()      { return _json; }
+    JsonType*       getRoot()          { return _json.getRoot(); }
+    JsonObject&     getJSON()          { return _json.getJSON(); }
+
+    size_t          getConsumed()  const { return _consumed; }
+    size_t          getOffset()    const { return _offset; }
+
+    size_t          getErrorPos()  const { return _errpos; }
+    std::string     getErrorStr()  const { return _errstr; }
+
+    void            setValidateUtf8 ( bool validate );
+
+  private:
+
+    typedef enum PushState {
+        PUSH_VALUE,        // a value
+        PUSH_FIRST_VALUE,  // a value or the end of an empty array
+        PUSH_FIRST_KEY,    // a key or the end of an empty object
+        PUSH_KEY,          // a key
+        PUSH_ASSIGN,       // the name separator
+        PUSH_NEXT,         // a value separator or the end of the container
+        PUSH_DONE,
+        PUSH_ERROR
+    } push_t;
+
+    typedef enum PushToken {
+        PTOK_NONE,
+        PTOK_STRING,
+        PTOK_KEY,
+        PTOK_SCALAR
+    } ptok_t;
+
+    bool            beginValue   ( const char *& p, const char * end );
+    bool            scanString   ( const char *& p, const char * end );
+    bool            scanScalar   ( const char *& p, const char * end );
+    bool            endToken     ( const char * p );
+    bool            parseToken   ( const char * beg, const char * end );
+    void            addValue     ( JsonType * item );
+    bool            endContainer ( const char * p, const char * end );
+    bool            setError     ( const char * p, const char * end );
+    bool            setError     ( size_t pos, const std::string & errstr );
+
+  private:
+
+    JSON                         _json;
+    JsonTreeBuilder              _builder;
+    JsonParser<JsonTreeBuilder>  _parser;
+    std::vector<JsonType*>       _stack;
+    std::string                  _key;
+    std::string                  _token;
+    push_t                       _state;
+    ptok_t                       _tok;
+    bool                         _escape;
+    size_t                       _bom;
+    const char *                 _buf;
+    const char *                 _tokbeg;
+    size_t                       _offset;
+    size_t                       _tokpos;
+    size_t                       _consumed;
+    size_t                       _errpos;
+    std::string                  _errstr;
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONPUSHPARSER_H_
@@ -0,0 +1,319 @@
+/**
+  * @file JsonTape.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONTAPE_H_
+#define _TCAJSON_JSONTAPE_H_
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JsonParser.hpp"
+#include "JsonTreeBuilder.hpp"
+
+
+namespace tcajson {
+
+
+class JsonTape;
+
+
+/** A single value of a JsonTape. Containers are followed by their
+  * members, an object holding a key node before each value, and record
+  * the index of the node following the container so that a subtree may
+  * be skipped in one step.
+ **/
+struct JsonTapeNode {
+    json_t    type;
+    uint32_t  len;     // string length, or container element count
+    uint32_t  next;    // index of the next sibling
+    uint8_t   ntype;   // the jnum_t of a number
+    bool      pooled;  // string is held in the tape's pool
+    union {
+        size_t    off;   // string offset into the input or pool
+        int64_t   ival;
+        uint64_t  uval;
+        double    dval;
+        bool      bval;
+    };
+};
+
+
+/** The JsonCursor class is a lightweight reference to a value of a
+  * JsonTape. Members are located by walking the tape, and values are
+  * returned directly from it, so no JsonType is allocated unless a
+  * subtree is explicitly materialized. A cursor that does not refer to
+  * a value, such as the result of looking up a missing key, is not
+  * valid() and reads as null. Accessors of the wrong type return an
+  * empty or zero value. Cursors are only valid while the tape, and the
+  * input it was parsed from, are unchanged.
+ **/
+class JsonCursor {
+
+  public:
+
+    class iterator {
+      public:
+        typedef std::forward_iterator_tag  iterator_category;
+        typedef JsonCursor                 value_type;
+        typedef std::ptrdiff_t             difference_type;
+        typedef const JsonCursor*          pointer;
+        typedef JsonCursor                 reference;
+
+        iterator() : _tape(nullptr), _idx(0), _object(false) {}
+        iterator ( const JsonTape * tape, uint32_t idx, bool object )
+            : _tape(tape), _idx(idx), _object(object)
+        {}
+
+        JsonCursor  operator*() const;
+        iterator&   operator++();
+        iterator    operator++ ( int ) { iterator it = *this; ++(*this); return it; }
+
+        bool  operator== ( const iterator & it ) const { return _idx == it._idx; }
+        bool  operator!= ( const iterator & it ) const { return _idx != it._idx; }
+
+      private:
+        const JsonTape *  _tape;
+        uint32_t          _idx;
+        bool              _object;
+    };
+
+  public:
+
+    JsonCursor() : _tape(nullptr), _idx(0), _key(0) {}
+    JsonCursor ( const JsonTape * tape, uint32_t idx, uint32_t key = 0 )
+        : _tape(tape), _idx(idx), _key(key)
+    {}
+
+    bool              valid() const    { return _tape != nullptr; }
+    explicit operator bool() const     { return this->valid(); }
+
+    json_t            getType() const;
+    size_t            size()    const;
+
+    JsonCursor        operator[] ( std::string_view key ) const { return this->find(key); }
+    JsonCursor        operator[] ( size_t index ) const;
+    JsonCursor        find       ( std::string_view key ) const;
+
+    iterator          begin() const;
+    iterator          end()   const;
+
+    /** The key of an object member reached by iteration or find() */
+    std::string_view  getKey() const;
+
+    std::string_view  getString()   const;
+    int64_t           getInteger()  const;
+    uint64_t          getUnsigned() const;
+    double            getDouble()   const;
+    bool              getBoolean()  const;
+    bool              isNull()      const  { return this->getType() == JSON_NULL; }
+
+    JsonType*         materialize() const;
+
+    template <typename Handler>
+    bool              accept ( Handler & handler ) const;
+
+  private:
+
+    const JsonTapeNode&  node() const;
+
+    template <typename Handler>
+    static bool          Replay ( const JsonTape * tape, uint32_t & idx, Handler & handler );
+
+  private:
+
+    const JsonTape *  _tape;
+    uint32_t          _idx;
+    uint32_t          _key;
+};
+
+
+/** The JsonTapeBuilder is the JsonParser handler that records a
+  * document onto a JsonTape.
+ **/
+class JsonTapeBuilder : public JsonHandler {
+
+  public:
+
+    explicit JsonTapeBuilder ( JsonTape & tape ) : _tape(tape) {}
+
+    bool  startObject();
+    bool  endObject();
+    bool  startArray();
+    bool  endArray();
+    bool  key      ( std::string_view k );
+    bool  string   ( std::string_view str );
+    bool  integer  ( int64_t  val );
+    bool  uinteger ( uint64_t val );
+    bool  number   ( double   val );
+    bool  boolean  ( bool     b );
+    bool  null();
+
+    void  reset() { _stack.clear(); }
+
+  private:
+
+    JsonTapeNode&  add ( json_t t );
+    void           open ( json_t t );
+    void           close();
+
+  private:
+
+    JsonTape &             _tape;
+    std::vector<uint32_t>  _stack;
+};
+
+
+/** The JsonTape class provides on-demand access to a document. The
+  * input is validated and recorded once onto a flat tape of nodes, and
+  * values are read through JsonCursors, so a consumer that touches a
+  * few fields of a large document never allocates the JsonObject,
+  * JsonArray and JsonString nodes of the rest of it. Strings without
+  * escapes refer to the input, which is not copied and must outlive
+  * the tape, while escaped strings are decoded into a pool. Any cursor
+  * may be materialized into a tree of JsonTypes as needed. Unlike
+  * JSON::parse, duplicate keys are not rejected, and find() returns
+  * the first member with a given key.
+ **/
+class JsonTape {
+
+  public:
+
+    JsonTape();
+    ~JsonTape();
+
+    bool          parse ( std::string_view str );
+    void          clear();
+
+    JsonCursor    getRoot() const;
+    JsonCursor    operator[] ( std::string_view key ) const { return this->getRoot()[key]; }
+
+    size_t        size()  const { return _nodes.size(); }
+    bool          empty() const { return _nodes.empty(); }
+
+    void          setValidateUtf8 ( bool validate ) { _parser.setValidateUtf8(validate); }
+
+    size_t        getErrorPos() const { return _parser.getErrorPos(); }
+    std::string   getErrorStr() const { return _parser.getErrorStr(); }
+
+  private:
+
+    friend class JsonCursor;
+    friend class JsonTapeBuilder;
+
+    std::string_view  getString ( const JsonTapeNode & n ) const
+    {
+        const char * base = n.pooled ? _pool.data() : _input.data();
+        return std::string_view(base + n.off, n.len);
+    }
+
+  private:
+
+    std::vector<JsonTapeNode>     _nodes;
+    std::string                   _pool;
+    std::string_view              _input;
+    JsonTapeBuilder               _builder;
+    JsonParser<JsonTapeBuilder>   _parser;
+};
+
+// ------------------------------------------------------------------------- //
+
+/** Replays the events of the value at this cursor to the handler, as
+  * if parsing its text, and returns false if the handler stopped.
+ **/
+template <typename Handler>
+inline bool
+JsonCursor::accept ( Handler & handler ) const
+{
+    uint32_t  idx = _idx;
+
+    if ( _tape == nullptr )
+        return handler.null();
+
+    return JsonCursor::Replay(_tape, idx, handler);
+}
+
+
+template <typename Handler>
+inline bool
+JsonCursor::Replay ( const JsonTape * tape, uint32_t & idx, Handler & handler )
+{
+    const JsonTapeNode & n = tape->_nodes[idx];
+    uint32_t             end;
+
+    switch ( n.type ) {
+        case JSON_OBJECT:
+            if ( ! handler.startObject() )
+                return false;
+            end = n.next;
+            ++idx;
+            while ( idx < end ) {
+                if ( ! handler.key(tape->getString(tape->_nodes[idx++])) )
+                    return false;
+                if ( ! Replay(tape, idx, handler) )
+                    return false;
+            }
+            return handler.endObject();
+
+        case JSON_ARRAY:
+            if ( ! handler.startArray() )
+                return false;
+            end = n.next;
+            ++idx;
+            while ( idx < end ) {
+                if ( ! Replay(tape, idx, handler) )
+                    return false;
+            }
+            return handler.endArray();
+
+        case JSON_STRING:
+            ++idx;
+            return handler.string(tape->getString(n));
+
+        case JSON_NUMBER:
+            ++idx;
+            if ( n.ntype == JSON_NUMBER_INT64 )
+                return handler.integer(n.ival);
+            if ( n.ntype == JSON_NUMBER_UINT64 )
+                return handler.uinteger(n.uval);
+            return handler.number(n.dval);
+
+        case JSON_BOOLEAN:
+            ++idx;
+            return handler.boolean(n.bval);
+
+        case JSON_NULL:
+        default:
+            break;
+    }
+
+    ++idx;
+
+    return handler.null();
+}
+
+} // namespace
+
+#endif // _TCAJSON_JSONTAPE_H_
@@ -0,0 +1,194 @@
+/**
+  * @file JsonTokenizer.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONTOKENIZER_H_
+#define _TCAJSON_JSONTOKENIZER_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "JsonType.hpp"
+#include "JsonLiteral.hpp"
+#include "JsonIndex.h"
+#include "JsonKernels.h"
+
+
+namespace tcajson {
+
+
+#define TCAJSON_ERRSTRLEN   48
+
+
+/* Character classes used by the scanning functions */
+enum JsonCharClass : uint8_t {
+    JSON_CC_SPACE  = 0x01,
+    JSON_CC_DIGIT  = 0x02,
+    JSON_CC_NEST   = 0x04   // quotes and brackets, for skipValue()
+};
+
+
+/* 256 entry lookup table mapping each input byte to its JsonCharClass */
+inline constexpr std::array<uint8_t, 256> JsonCharTable = []
+{
+    std::array<uint8_t, 256> tbl{};
+
+    tbl[(uint8_t) TOKEN_WS] = JSON_CC_SPACE;
+    tbl[(uint8_t) '\t']     = JSON_CC_SPACE;
+    tbl[(uint8_t) '\n']     = JSON_CC_SPACE;
+    tbl[(uint8_t) '\r']     = JSON_CC_SPACE;
+
+    for ( char c = '0'; c <= '9'; ++c )
+        tbl[(uint8_t) c] = JSON_CC_DIGIT;
+
+    tbl[(uint8_t) TOKEN_STRING_SEPARATOR] = JSON_CC_NEST;
+    tbl[(uint8_t) TOKEN_OBJECT_BEGIN]     = JSON_CC_NEST;
+    tbl[(uint8_t) TOKEN_OBJECT_END]       = JSON_CC_NEST;
+    tbl[(uint8_t) TOKEN_ARRAY_BEGIN]      = JSON_CC_NEST;
+    tbl[(uint8_t) TOKEN_ARRAY_END]        = JSON_CC_NEST;
+
+    return tbl;
+}();
+
+
+/** The JsonTokenizer class holds the input cursor shared by all of
+  * the parsers and scans the individual tokens of a document: strings,
+  * numbers and literals, along with the whitespace between them. It has
+  * no knowledge of the structure of a document, which is left to the
+  * JsonParser. Scanning uses the active JsonKernels, and may follow a
+  * JsonIndex to move directly between tokens. Errors record the offset
+  * within the input and a snippet of the text at that position.
+ **/
+class JsonTokenizer {
+
+  public:
+
+    JsonTokenizer();
+    ~JsonTokenizer();
+
+    void         reset    ( std::string_view str );
+    void         setIndex ( const JsonIndex * index );
+
+    bool         parseString  ( std::string_view & str );
+    bool         parseNumber  ( jnum_t & type, uint64_t & ival, double & val );
+    bool         parseBoolean ( bool & b );
+    bool         parseNull();
+
+    bool         skipValue();
+    void         skipSpace();
+    bool         nextArraySize ( size_t & count );
+
+    bool         atEnd()  const { return _pos == _end; }
+    char         peek()   const { return *_pos; }
+    size_t       getPos() const { return _pos - _beg; }
+
+    void         setValidateUtf8 ( bool validate ) { _utf8 = validate; }
+    bool         getValidateUtf8() const { return _utf8; }
+
+    size_t       getErrorPos() const { return _errpos; }
+    std::string  getErrorStr() const { return _errstr; }
+
+    bool         setError();
+
+    static bool  IsSpace ( char c )
+    {
+        return (JsonCharTable[(uint8_t) c] & JSON_CC_SPACE) != 0;
+    }
+
+    static bool  IsDigit ( char c )
+    {
+        return (JsonCharTable[(uint8_t) c] & JSON_CC_DIGIT) != 0;
+    }
+
+  protected:
+
+    bool         parseEscaped ( const char * q );
+    bool         parseUnicode ( uint32_t & cp );
+    bool         parseHex     ( uint32_t & val );
+    bool         skipString();
+
+  protected:
+
+    const char *        _beg;
+    const char *        _pos;
+    const char *        _end;
+    const uint32_t *    _ipos;
+    const uint32_t *    _iend;
+    const uint32_t *    _isize;
+    const uint32_t *    _isend;
+    const JsonKernels * _kernels;
+    bool                _utf8;
+    std::string         _scratch;
+    std::string         _nest;
+    size_t              _errpos;
+    size_t              _errlen;
+    std::string         _errstr;
+};
+
+
+/** Advances the input position past any whitespace. When parsing
+  * from an index, the position moves directly to the next indexed
+  * token instead.
+ **/
+inline void
+JsonTokenizer::skipSpace()
+{
+    if ( _ipos != nullptr ) {
+        if ( _pos < _end && IsSpace(*_pos) ) {
+            uint32_t off = _pos - _beg;
+
+            while ( _ipos < _iend && *_ipos < off )
+                ++_ipos;
+
+            _pos = (_ipos < _iend) ? _beg + *_ipos : _end;
+        }
+        return;
+    }
+
+    // single separating spaces are common, longer runs use the kernel
+    if ( _pos < _end && IsSpace(*_pos) ) {
+        if ( ++_pos < _end && IsSpace(*_pos) )
+            _pos = _kernels->skipSpace(_pos, _end);
+    }
+}
+
+
+/** Sets 'count' to the number of elements of the next array of the
+  * input, in document order, as counted by the index. Returns false
+  * when not parsing from an index.
+ **/
+inline bool
+JsonTokenizer::nextArraySize ( size_t & count )
+{
+    if ( _isize == _isend )
+        return false;
+
+    count = *_isize++;
+
+    return true;
+}
+
+} // namespace
+
+#endif // _TCAJSON_JSONTOKENIZER_H_
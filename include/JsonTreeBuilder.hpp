@@ -0,0 +1,399 @@
+/**
+  * @file JsonTreeBuilder.hpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONTREEBUILDER_HPP_
+#define _TCAJSON_JSONTREEBUILDER_HPP_
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "JsonParser.hpp"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonArena.h"
+
+
+namespace tcajson {
+
+
+/** The JsonTreeBuilder is the JsonParser handler that builds the tree
+  * of JsonTypes for a document. Containers are attached to their parent
+  * as they open and tracked on a stack, so each value is allocated once
+  * and inserted in place. A target may be given to receive the root:
+  * when the document is an object or array of the same type as the
+  * target, its members are added to the target rather than to a new
+  * container, otherwise a new root is allocated. A duplicate key within
+  * an object stops the parse. Objects, arrays and strings use the
+  * memory resource given by setMemoryResource() for their members,
+  * keys and payloads. With a JsonArena as the resource, the values are
+  * allocated from the arena as well, and otherwise with new.
+  *
+  * Given a recycle limit, values freed through recycle() are kept on
+  * free lists per type, up to the limit, and reused by the next parse
+  * instead of being allocated. Emptied objects and arrays keep the
+  * capacity of their storage and strings keep their buffer, so parsing
+  * documents of the same shape repeatedly reaches a steady state that
+  * allocates little. Only values of the types the builder creates,
+  * using its memory resource, are kept.
+ **/
+class JsonTreeBuilder : public JsonHandler {
+
+  public:
+
+    explicit JsonTreeBuilder ( JsonType * target = nullptr )
+        : _target(target),
+          _root(nullptr),
+          _mr(std::pmr::get_default_resource()),
+          _arena(nullptr),
+          _limit(0),
+          _pooled(0)
+    {}
+
+    ~JsonTreeBuilder()
+    {
+        this->reset();
+        this->shrink();
+    }
+
+    /** Discards any partial tree and sets the target of the next parse */
+    void  reset ( JsonType * target = nullptr )
+    {
+        if ( _root != _target )
+            this->recycle(_root);
+
+        _stack.clear();
+        _target = target;
+        _root   = nullptr;
+    }
+
+    /** Sets the memory resource of new values, or the default if nullptr */
+    void  setMemoryResource ( std::pmr::memory_resource * mr )
+    {
+        if ( mr == nullptr )
+            mr = std::pmr::get_default_resource();
+        if ( mr != _mr )
+            this->shrink();
+
+        _mr    = mr;
+        _arena = dynamic_cast<JsonArena*>(mr);
+    }
+
+    std::pmr::memory_resource*  getMemoryResource() const { return _mr; }
+
+    /** Returns the root of the parsed document, which may be the target */
+    JsonType*  getRoot() { return _root; }
+
+    /** Returns the root and releases it to the caller */
+    JsonType*  release()
+    {
+        JsonType * root = _root;
+        _root = nullptr;
+        return root;
+    }
+
+    /** Sets the number of freed values kept for reuse, freeing any
+      * beyond the limit. A limit of zero, the default, disables reuse.
+     **/
+    void  setRecycleLimit ( size_t nodes )
+    {
+        _limit = nodes;
+
+        for ( std::vector<JsonType*> & pool : _free ) {
+            while ( _pooled > _limit && ! pool.empty() ) {
+                delete pool.back();
+                pool.pop_back();
+                --_pooled;
+            }
+        }
+    }
+
+    size_t  getRecycleLimit() const { return _limit; }
+    size_t  getRecycled()     const { return _pooled; }
+
+    /** Frees the values kept for reuse */
+    void  shrink()
+    {
+        for ( std::vector<JsonType*> & pool : _free ) {
+            for ( JsonType * item : pool )
+                delete item;
+            pool.clear();
+            pool.shrink_to_fit();
+        }
+
+        _pooled = 0;
+    }
+
+    /** Frees the value and its descendants, keeping those the builder
+      * could reuse, up to the recycle limit.
+     **/
+    void  recycle ( JsonType * item )
+    {
+        if ( item == nullptr )
+            return;
+
+        if ( _limit == 0 || ! this->reusable(item) ) {
+            delete item;
+            return;
+        }
+
+        this->recycleItems(item);
+
+        if ( _pooled < _limit ) {
+            _free[item->getType()].push_back(item);
+            ++_pooled;
+        } else {
+            delete item;
+        }
+    }
+
+    /** Recycles the members or elements of an object or array, leaving
+      * it empty with the capacity of its storage.
+     **/
+    void  recycleItems ( JsonType * item )
+    {
+        if ( item->getType() == JSON_OBJECT ) {
+            JsonObject * obj = (JsonObject*) item;
+
+            if ( _limit > 0 ) {
+                JsonObject::iterator  jIter;
+                for ( jIter = obj->begin(); jIter != obj->end(); ++jIter ) {
+                    this->recycle(jIter->second);
+                    jIter->second = nullptr;
+                }
+            }
+            obj->clear();
+        } else if ( item->getType() == JSON_ARRAY ) {
+            JsonArray * ary = (JsonArray*) item;
+
+            if ( _limit > 0 ) {
+                for ( JsonType *& elem : ary->items() ) {
+                    this->recycle(elem);
+                    elem = nullptr;
+                }
+            }
+            ary->clear();
+        }
+    }
+
+  public:
+
+    bool  startObject()
+    {
+        JsonType * obj;
+
+        if ( _stack.empty() && _target != nullptr && _target->getType() == JSON_OBJECT ) {
+            obj = _root = _target;
+        } else {
+            obj = this->create<JsonObject>();
+            this->add(obj);
+        }
+
+        _stack.push_back(obj);
+
+        return true;
+    }
+
+    bool  startArray()
+    {
+        JsonType * ary;
+
+        if ( _stack.empty() && _target != nullptr && _target->getType() == JSON_ARRAY ) {
+            ary = _root = _target;
+        } else {
+            ary = this->create<JsonArray>();
+            this->add(ary);
+        }
+
+        _stack.push_back(ary);
+
+        return true;
+    }
+
+    /** Reserves the elements of the array just started */
+    bool  arraySize ( size_t count )
+    {
+        JsonArray * ary = (JsonArray*) _stack.back();
+        ary->reserve(ary->size() + count);
+        return true;
+    }
+
+    bool  endObject() { _stack.pop_back(); return true; }
+    bool  endArray()  { _stack.pop_back(); return true; }
+
+    bool  key ( std::string_view k )
+    {
+        _key.assign(k);
+
+        return ! ((JsonObject*) _stack.back())->exists(_key);  // duplicate key
+    }
+
+    bool  string ( std::string_view str )
+    {
+        JsonString * item = this->create<JsonString>();
+        item->value().assign(str.data(), str.size());
+        this->add(item);
+        return true;
+    }
+
+    bool  integer ( int64_t val )
+    {
+        JsonNumber * num = this->create<JsonNumber>();
+        num->setInteger(val);
+        this->add(num);
+        return true;
+    }
+
+    bool  uinteger ( uint64_t val )
+    {
+        JsonNumber * num = this->create<JsonNumber>();
+        num->setUnsigned(val);
+        this->add(num);
+        return true;
+    }
+
+    bool  number ( double val )
+    {
+        JsonNumber * num = this->create<JsonNumber>();
+        num->setDouble(val);
+        this->add(num);
+        return true;
+    }
+
+    bool  boolean ( bool b )
+    {
+        JsonBoolean * item = this->create<JsonBoolean>();
+        item->value() = b;
+        this->add(item);
+        return true;
+    }
+
+    bool  null()
+    {
+        this->add(this->create<JsonType>());
+        return true;
+    }
+
+  private:
+
+    template <typename T>
+    T*    create()
+    {
+        if ( _arena != nullptr )
+            return _arena->create<T>();
+
+        if ( _pooled > 0 ) {
+            std::vector<JsonType*> & pool = _free[TypeOf<T>()];
+
+            if ( ! pool.empty() ) {
+                T * item = (T*) pool.back();
+                pool.pop_back();
+                --_pooled;
+                return item;
+            }
+        }
+
+        if constexpr ( std::uses_allocator_v<T, JsonAllocator> )
+            return new T(JsonAllocator(_mr));
+        else
+            return new T();
+    }
+
+    template <typename T>
+    static constexpr json_t  TypeOf()
+    {
+        if constexpr ( std::is_same_v<T, JsonObject> )
+            return JSON_OBJECT;
+        else if constexpr ( std::is_same_v<T, JsonArray> )
+            return JSON_ARRAY;
+        else if constexpr ( std::is_same_v<T, JsonString> )
+            return JSON_STRING;
+        else if constexpr ( std::is_same_v<T, JsonNumber> )
+            return JSON_NUMBER;
+        else if constexpr ( std::is_same_v<T, JsonBoolean> )
+            return JSON_BOOLEAN;
+        else
+            return JSON_NULL;
+    }
+
+    /** Returns true if the value is of a type the builder creates, with
+      * its memory resource, and so may be reused.
+     **/
+    bool  reusable ( const JsonType * item ) const
+    {
+        if ( item->inArena() )
+            return false;
+
+        switch ( item->getType() ) {
+            case JSON_OBJECT:
+                return typeid(*item) == typeid(JsonObject)
+                    && ((const JsonObject*) item)->get_allocator().resource() == _mr;
+            case JSON_ARRAY:
+                return typeid(*item) == typeid(JsonArray)
+                    && ((const JsonArray*) item)->get_allocator().resource() == _mr;
+            case JSON_STRING:
+                return typeid(*item) == typeid(JsonString)
+                    && ((const JsonString*) item)->value().get_allocator().resource() == _mr;
+            case JSON_NUMBER:
+                return typeid(*item) == typeid(JsonNumber);
+            case JSON_BOOLEAN:
+                return typeid(*item) == typeid(JsonBoolean);
+            default:
+                break;
+        }
+
+        return typeid(*item) == typeid(JsonType);
+    }
+
+    /** Attaches the value to the open container, or makes it the root */
+    void  add ( JsonType * item )
+    {
+        if ( _stack.empty() ) {
+            _root = item;
+            return;
+        }
+
+        JsonType * parent = _stack.back();
+
+        if ( parent->getType() == JSON_OBJECT )
+            ((JsonObject*) parent)->insert(_key, item);
+        else
+            ((JsonArray*) parent)->insert(item);
+    }
+
+  private:
+
+    JsonType *                   _target;
+    JsonType *                   _root;
+    std::pmr::memory_resource *  _mr;
+    JsonArena *                  _arena;
+    std::vector<JsonType*>       _stack;
+    std::string                  _key;
+    std::vector<JsonType*>       _free[JSON_BOOLEAN + 1];
+    size_t                       _limit;
+    size_t                       _pooled;
+};
+
+} // namespace
+
+#endif // _TCAJSON_JSONTREEBUILDER_HPP_
@@ -24,6 +24,8 @@
 #ifndef _TCAJSON_JSONTYPE_HPP_
 #define _TCAJSON_JSONTYPE_HPP_
 
+#include <memory_resource>
+#include <new>
 #include <string>
 
 
@@ -51,17 +53,49 @@ typedef enum JsonValueType {
 } json_t;
 
 
-/**  JsonType is the abstract base class of all JSON types.  */
+/**  The allocator of the JsonObject, JsonArray and JsonString types,
+  *  drawing their members, keys and strings from a memory resource.
+ **/
+typedef std::pmr::polymorphic_allocator<>  JsonAllocator;
+
+
+/**  JsonType is the abstract base class of all JSON types. A value
+  *  allocated from a JsonArena is flagged as such, and deleting it only
+  *  destroys it, its memory being released along with the arena.
+ **/
 class JsonType {
 
   public:
 
-    JsonType ( json_t  t = JSON_NULL ) : _type(t) {}
+    JsonType ( json_t  t = JSON_NULL ) : _type(t), _arena(false) {}
+    JsonType ( const JsonType & t ) : _type(t._type), _arena(false) {}
     virtual ~JsonType() {}
 
+    JsonType& operator= ( const JsonType & t )
+    {
+        this->_type = t._type;
+        return *this;
+    }
+
     json_t   getType()      const { return this->_type; }
     json_t   getValueType() const { return this->getType(); }
 
+    /** Returns true if this value was allocated from a JsonArena */
+    bool     inArena()      const { return this->_arena; }
+
+
+    void operator delete ( JsonType * item, std::destroying_delete_t )
+    {
+        bool arena = item->_arena;
+
+        item->~JsonType();
+
+        if ( ! arena )
+            ::operator delete(item);
+    }
+
+    void operator delete ( void * p ) { ::operator delete(p); }
+
 
     virtual std::string toString ( bool asJson = true ) const
     {
@@ -73,7 +107,10 @@ class JsonType {
 
   protected:
 
+    friend class JsonArena;
+
     json_t   _type;
+    bool     _arena;
 };
 
 
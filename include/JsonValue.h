@@ -0,0 +1,390 @@
+/**
+  * @file JsonValue.h
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#ifndef _TCAJSON_JSONVALUE_H_
+#define _TCAJSON_JSONVALUE_H_
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "JsonType.hpp"
+#include "JsonLiteral.hpp"
+#include "JsonParser.hpp"
+
+
+namespace tcajson {
+
+
+#define TCAJSON_VALUE_INLINESZ  14
+
+
+/** The JsonValue class is a compact, 16 byte representation of any
+  * JSON value. Null, booleans and numbers are held inline, as are
+  * strings of up to TCAJSON_VALUE_INLINESZ bytes, while longer strings,
+  * arrays and objects hold a pointer to their payload. Arrays and
+  * objects are vectors of JsonValues, an object member being a pair of
+  * a string value for the key and the value, kept in insertion order.
+  * There is no virtual dispatch and no per-value allocation of
+  * scalars, so a document of JsonValues is several times smaller than
+  * a tree of JsonTypes. Payloads are drawn from the allocator given
+  * when the value is created, which is remembered by the payload, and
+  * copies use the default resource unless another is given. A string
+  * created by Borrow() refers to its characters without copying them,
+  * which must then outlive the value, while a copy of it owns its
+  * string. Accessors of the wrong type return an empty or zero value.
+  * A JsonValue is converted to and from JsonTypes with materialize()
+  * and FromType(). It is a separate document type, and the JsonType
+  * classes are not views over it: a JsonObject or JsonArray keeps its
+  * own heap nodes, and converting between the two copies the values.
+  *
+  * Payloads are reference counted, and share() returns a value sharing
+  * the payload of this one in constant time rather than copying it. A
+  * shared container is copied on the first access that may modify it,
+  * the non-const getArray(), getObject(), find() and insert(), and the
+  * copy shares the members of the original, so that modifying a shared
+  * document copies only the containers on the path to the change.
+  * Values sharing a payload may be used from different threads, while
+  * a single value is not synchronized, and references taken from the
+  * non-const accessors must not be used after sharing the value.
+ **/
+class JsonValue {
+
+  public:
+
+    typedef std::pmr::vector<JsonValue>         Array;
+    typedef std::pair<JsonValue, JsonValue>     Member;
+    typedef std::pmr::vector<Member>            Object;
+
+  public:
+
+    constexpr JsonValue() noexcept
+        : _data{}, _sub(0), _type(JSON_NULL)
+    {}
+
+    JsonValue ( std::nullptr_t ) noexcept : JsonValue() {}
+    JsonValue ( bool b ) noexcept;
+    JsonValue ( double val ) noexcept;
+
+    template <std::integral T>
+    JsonValue ( T val ) noexcept : JsonValue()
+    {
+        if constexpr ( std::is_signed_v<T> )
+            this->setInteger(val);
+        else
+            this->setUnsigned(val);
+    }
+
+    JsonValue ( std::string_view str, const JsonAllocator & alloc = JsonAllocator() );
+    JsonValue ( const char * str, const JsonAllocator & alloc = JsonAllocator() );
+    JsonValue ( json_t t, const JsonAllocator & alloc = JsonAllocator() );
+
+    JsonValue ( const JsonValue & val );
+    JsonValue ( const JsonValue & val, const JsonAllocator & alloc );
+    JsonValue ( JsonValue && val ) noexcept;
+
+    ~JsonValue();
+
+    JsonValue&        operator= ( const JsonValue & val );
+    JsonValue&        operator= ( JsonValue && val ) noexcept;
+
+    json_t            getType()       const { return (json_t) _type; }
+    jnum_t            getNumberType() const;
+    bool              isNull()        const { return _type == JSON_NULL; }
+    bool              isInteger()     const;
+    bool              isBorrowed()    const { return _type == JSON_STRING && _sub == StringView; }
+    bool              isShared()      const;
+    size_t            size()          const;
+
+    std::string_view  getString()   const;
+    int64_t           getInteger()  const;
+    uint64_t          getUnsigned() const;
+    double            getDouble()   const;
+    bool              getBoolean()  const;
+
+    void              setInteger  ( int64_t  val ) noexcept;
+    void              setUnsigned ( uint64_t val ) noexcept;
+
+    /** Members and elements, or a null value if there is none */
+    const JsonValue&  operator[] ( std::string_view key ) const;
+    const JsonValue&  operator[] ( size_t index ) const;
+
+    JsonValue*        find ( std::string_view key );
+    const JsonValue*  find ( std::string_view key ) const;
+
+    Array&            getArray()  noexcept(false);
+    const Array&      getArray()  const noexcept(false);
+    Object&           getObject() noexcept(false);
+    const Object&     getObject() const noexcept(false);
+
+    JsonValue&        insert ( std::string_view key, JsonValue && val ) noexcept(false);
+    JsonValue&        insert ( JsonValue && val ) noexcept(false);
+
+    JsonValue         share() const noexcept;
+
+    std::pmr::memory_resource*  getMemoryResource() const;
+
+    std::string       toString ( bool asJson = true ) const;
+
+    JsonType*         materialize ( const JsonAllocator & alloc = JsonAllocator() ) const;
+
+    template <typename Handler>
+    bool              accept ( Handler & handler ) const;
+
+    static JsonValue  FromType ( const JsonType * item,
+                                 const JsonAllocator & alloc = JsonAllocator() );
+
+    static JsonValue  Borrow   ( std::string_view str,
+                                 const JsonAllocator & alloc = JsonAllocator() );
+
+  private:
+
+    /* the header of a string longer than TCAJSON_VALUE_INLINESZ,
+     * allocated along with the characters that follow it */
+    struct String {
+        std::pmr::memory_resource *     mr;
+        uint32_t                        len;
+        mutable std::atomic<uint32_t>   refs;
+    };
+
+    /* an array or object payload, with its count of sharing values */
+    template <typename T>
+    struct Shared : public T {
+        using T::T;
+        mutable std::atomic<uint32_t>   refs = 1;
+    };
+
+    typedef Shared<Array>   SharedArray;
+    typedef Shared<Object>  SharedObject;
+
+    static const uint8_t  StringHeap = 0xFF;
+    static const uint8_t  StringView = 0xFE;
+
+    template <typename T>
+    T      load() const { T v; std::memcpy(&v, _data, sizeof(T)); return v; }
+
+    template <typename T>
+    void   store ( T v ) { std::memcpy(_data, &v, sizeof(T)); }
+
+    std::atomic<uint32_t>*  refs() const;
+
+    void   release() noexcept;
+    void   unshare();
+    void   toString ( std::string & str, bool asJson ) const;
+
+  private:
+
+    alignas(8) unsigned char  _data[TCAJSON_VALUE_INLINESZ];
+    uint8_t                   _sub;    // jnum_t, inline string length, or StringHeap/View
+    uint8_t                   _type;   // json_t
+};
+
+
+/** The JsonValueBuilder is the JsonParser handler that builds a
+  * document of JsonValues into the given target, drawing its payloads
+  * from the allocator. The members of open containers are collected on
+  * stacks reused across documents, so that each container is allocated
+  * once, at its final size, when it closes. Given the input by
+  * setSource(), keys and strings without escapes are borrowed from the
+  * input rather than copied, and only strings with escapes are decoded
+  * into owned storage. Like the JsonTape, and unlike JSON::parse,
+  * duplicate keys are not rejected, and find() returns the first
+  * member with a given key.
+ **/
+class JsonValueBuilder : public JsonHandler {
+
+  public:
+
+    explicit JsonValueBuilder ( JsonValue & target,
+                                const JsonAllocator & alloc = JsonAllocator() )
+        : _root(target),
+          _mr(alloc.resource())
+    {}
+
+    /** Clears the target and any partial document */
+    void  reset()
+    {
+        _open.clear();
+        _members.clear();
+        _elements.clear();
+        _root = JsonValue();
+    }
+
+    /** Sets the input of the next parse, which must outlive the
+      * document, to borrow strings from. An empty view copies all
+      * strings, as by default.
+     **/
+    void  setSource ( std::string_view input ) { _src = input; }
+
+    std::string_view  getSource() const { return _src; }
+
+    bool  startObject()
+    {
+        _open.emplace_back(JSON_OBJECT, _members.size());
+        return true;
+    }
+
+    bool  startArray()
+    {
+        _open.emplace_back(JSON_ARRAY, _elements.size());
+        return true;
+    }
+
+    bool  endObject()
+    {
+        JsonValue           val(JSON_OBJECT, _mr);
+        JsonValue::Object & obj   = val.getObject();
+        size_t              start = _open.back().second;
+
+        obj.reserve(_members.size() - start);
+        for ( size_t i = start; i < _members.size(); ++i )
+            obj.push_back(std::move(_members[i]));
+
+        _members.resize(start);
+        _open.pop_back();
+
+        return this->add(std::move(val));
+    }
+
+    bool  endArray()
+    {
+        JsonValue          val(JSON_ARRAY, _mr);
+        JsonValue::Array & ary   = val.getArray();
+        size_t             start = _open.back().second;
+
+        ary.reserve(_elements.size() - start);
+        for ( size_t i = start; i < _elements.size(); ++i )
+            ary.push_back(std::move(_elements[i]));
+
+        _elements.resize(start);
+        _open.pop_back();
+
+        return this->add(std::move(val));
+    }
+
+    bool  key ( std::string_view k )
+    {
+        _members.emplace_back(this->makeString(k), JsonValue());
+        return true;
+    }
+
+    bool  string   ( std::string_view str ) { return this->add(this->makeString(str)); }
+    bool  integer  ( int64_t  val )         { return this->add(JsonValue(val)); }
+    bool  uinteger ( uint64_t val )         { return this->add(JsonValue(val)); }
+    bool  number   ( double   val )         { return this->add(JsonValue(val)); }
+    bool  boolean  ( bool     b )           { return this->add(JsonValue(b)); }
+    bool  null()                            { return this->add(JsonValue()); }
+
+  private:
+
+    /** Borrows a string lying within the source, otherwise copies it */
+    JsonValue  makeString ( std::string_view str ) const
+    {
+        if ( str.data() >= _src.data() && str.data() + str.size() <= _src.data() + _src.size() )
+            return JsonValue::Borrow(str, _mr);
+        return JsonValue(str, _mr);
+    }
+
+    /** Adds the value to the open container, or makes it the root */
+    bool  add ( JsonValue && val )
+    {
+        if ( _open.empty() )
+            _root = std::move(val);
+        else if ( _open.back().first == JSON_OBJECT )
+            _members.back().second = std::move(val);
+        else
+            _elements.push_back(std::move(val));
+
+        return true;
+    }
+
+  private:
+
+    JsonValue &                               _root;
+    std::pmr::memory_resource *               _mr;
+    std::string_view                          _src;
+    std::vector<std::pair<json_t, size_t>>    _open;
+    std::vector<JsonValue::Member>            _members;
+    std::vector<JsonValue>                    _elements;
+};
+
+// ------------------------------------------------------------------------- //
+
+/** Replays the events of this value to the handler, as if parsing its
+  * text, and returns false if the handler stopped.
+ **/
+template <typename Handler>
+inline bool
+JsonValue::accept ( Handler & handler ) const
+{
+    switch ( this->getType() ) {
+        case JSON_OBJECT:
+            if ( ! handler.startObject() )
+                return false;
+            for ( const Member & m : this->getObject() ) {
+                if ( ! handler.key(m.first.getString()) || ! m.second.accept(handler) )
+                    return false;
+            }
+            return handler.endObject();
+
+        case JSON_ARRAY:
+            if ( ! handler.startArray() )
+                return false;
+            if ( ! handler.arraySize(this->size()) )
+                return false;
+            for ( const JsonValue & v : this->getArray() ) {
+                if ( ! v.accept(handler) )
+                    return false;
+            }
+            return handler.endArray();
+
+        case JSON_STRING:
+            return handler.string(this->getString());
+
+        case JSON_NUMBER:
+            if ( _sub == JSON_NUMBER_INT64 )
+                return handler.integer(this->getInteger());
+            if ( _sub == JSON_NUMBER_UINT64 )
+                return handler.uinteger(this->getUnsigned());
+            return handler.number(this->getDouble());
+
+        case JSON_BOOLEAN:
+            return handler.boolean(this->getBoolean());
+
+        case JSON_NULL:
+        default:
+            break;
+    }
+
+    return handler.null();
+}
+
+} // namespace
+
+#endif // _TCAJSON_JSONVALUE_H_
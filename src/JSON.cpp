@@ -23,14 +23,17 @@
 **/
 #define _TCAJSON_JSON_CPP_
 
-#include <set>
+#include <cstdint>
+#include <iterator>
 #include <stdexcept>
 
 #include "JSON.h"
+#include "JsonMappedFile.h"
 
 
 namespace tcajson {
 
+
 // ------------------------------------------------------------------------- //
 
 std::ostream&
@@ -75,6 +78,70 @@ operator<< ( std::ostream & strm, const JsonString & str )
     return strm;
 }
 
+/**  Escapes the given string for output as a JSON string value. The
+  *  active kernel locates each character requiring an escape, so runs
+  *  of plain characters are copied in bulk.
+ **/
+std::string
+JsonEscape ( std::string_view str )
+{
+    const JsonKernels & kernels = JsonKernels::Active();
+
+    const char * p   = str.data();
+    const char * end = p + str.size();
+    const char * q   = kernels.scanString(p, end);
+    std::string  out;
+
+    if ( q == end )
+        return std::string(str);
+
+    out.reserve(str.size() + 16);
+
+    while ( p < end )
+    {
+        out.append(p, q - p);
+
+        if ( q == end )
+            break;
+
+        switch ( *q ) {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\b':
+                out.append("\\b");
+                break;
+            case '\f':
+                out.append("\\f");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default: {
+                const char hex[] = "0123456789abcdef";
+                out.append("\\u00");
+                out.push_back(hex[((uint8_t) *q) >> 4]);
+                out.push_back(hex[((uint8_t) *q) & 0x0F]);
+                break;
+            }
+        }
+
+        p = q + 1;
+        q = kernels.scanString(p, end);
+    }
+
+    return out;
+}
+
 // ------------------------------------------------------------------------- //
 
 /**  Constructor for the JSON parser class. If a non-empty string
@@ -83,8 +150,12 @@ operator<< ( std::ostream & strm, const JsonString & str )
   *  invalid JSON.
  **/
 JSON::JSON ( const std::string & str )
-    : _errpos(0),
-      _errlen(TCAJSON_ERRSTRLEN)
+    : _root(new JsonObject()),
+      _arena(nullptr),
+      _mr(std::pmr::get_default_resource()),
+      _utf8(false),
+      _parser(_builder),
+      _errpos(0)
 {
     if ( ! str.empty() && ! this->parse(str) )
         throw ( std::runtime_error("Error parsing string to json") );
@@ -95,534 +166,486 @@ JSON::JSON ( const std::string & str )
   * as the root JsonObject.
  **/
 JSON::JSON ( const JsonObject & jobj )
-    : _root(jobj),
-      _errpos(0),
-      _errlen(TCAJSON_ERRSTRLEN)
+    : _root(new JsonObject(jobj)),
+      _arena(nullptr),
+      _mr(std::pmr::get_default_resource()),
+      _utf8(false),
+      _parser(_builder),
+      _errpos(0)
 {}
 
 
-/**  The JSON copy constructor */
+/** Construct an empty JSON Document whose values use the given memory
+  * resource, or the default resource if nullptr.
+ **/
+JSON::JSON ( std::pmr::memory_resource * mr )
+    : _root(nullptr),
+      _arena(nullptr),
+      _mr(std::pmr::get_default_resource()),
+      _utf8(false),
+      _parser(_builder),
+      _errpos(0)
+{
+    if ( mr != nullptr )
+        _mr = mr;
+
+    _root = new JsonObject(JsonAllocator(_mr));
+    _builder.setMemoryResource(_mr);
+}
+
+
+/**  The JSON copy constructor. The copy uses the default memory
+  *  resource, as with the copy of a std::pmr container.
+ **/
 JSON::JSON ( const JSON & json )
-    : _errpos(0),
-      _errlen(TCAJSON_ERRSTRLEN)
+    : _root(new JsonObject()),
+      _arena(nullptr),
+      _mr(std::pmr::get_default_resource()),
+      _utf8(false),
+      _parser(_builder),
+      _errpos(0)
 {
     *this = json;
 }
 
 
+/**  The JSON move constructor, taking the tree of 'json' along with
+  *  its arena or memory resource without copying it. The moved-from
+  *  document is left empty, keeping its settings.
+ **/
+JSON::JSON ( JSON && json )
+    : _root(nullptr),
+      _arena(nullptr),
+      _mr(std::pmr::get_default_resource()),
+      _utf8(false),
+      _parser(_builder),
+      _errpos(0)
+{
+    this->take(json);
+}
+
+
 /**  JSON destructor */
 JSON::~JSON()
-{}
+{
+    this->dispose();
+
+    delete _arena;
+}
 
 // ------------------------------------------------------------------------- //
 
-/** Assignment operator */
+/** Assignment operator, copying the document with the memory resource
+  * of this document.
+ **/
 JSON&
 JSON::operator= ( const JSON & json )
 {
     if ( this != &json ) {
-        this->_root.clear();
-        this->_root   = json._root;
+        this->dispose();
+        this->_root   = JSON::Copy(json._root, this->getMemoryResource());
+        this->_utf8   = json._utf8;
         this->_errpos = json._errpos;
-        this->_errlen = json._errlen;
         this->_errstr = json._errstr;
     }
 
     return *this;
 }
 
-// ------------------------------------------------------------------------- //
-
-/** Erases the current JSON document, clearing this object */
-void
-JSON::clear()
+/** Move assignment operator, freeing the current document and taking
+  * the tree of 'json' along with its arena or memory resource.
+ **/
+JSON&
+JSON::operator= ( JSON && json )
 {
-    this->_root.clear();
+    if ( this != &json ) {
+        this->dispose();
+        delete _arena;
+        _arena = nullptr;
+        this->take(json);
+    }
+
+    return *this;
 }
 
 
-bool
-JSON::empty() const
+/** Takes the tree and settings of 'json', leaving it an empty root
+  * object with the same settings and a new arena if it used one.
+ **/
+void
+JSON::take ( JSON & json )
 {
-    return _root.empty();
+    _root   = json._root;
+    _arena  = json._arena;
+    _mr     = json._mr;
+    _utf8   = json._utf8;
+    _errpos = json._errpos;
+    _errstr = std::move(json._errstr);
+
+    _builder.setMemoryResource(this->getMemoryResource());
+    _builder.setRecycleLimit(json._builder.getRecycleLimit());
+
+    json._root  = nullptr;
+    json._arena = (_arena != nullptr) ? new JsonArena() : nullptr;
+    json._root  = JsonCreate<JsonObject>(json.getMemoryResource());
+    json._builder.setMemoryResource(json.getMemoryResource());
 }
 
 // ------------------------------------------------------------------------- //
 
-/** Parses the given string as the root JsonObject. Returns a
-  * boolean indicating whether the parsing of the string was
-  * successful. The root JsonObject representing the document
-  * can be retrieved via the getJSON() method.
-  * Set clear to false to not clear the root JsonObject and
-  * essentially add the provided json string to the current
-  * object.
+/** Erases the current JSON document, leaving an empty root JsonObject.
+  * When using an arena, the whole document is released at once.
  **/
-bool
-JSON::parse ( const std::string & str, bool clear )
+void
+JSON::clear()
 {
-    std::string::size_type  indx;
-    bool  p = false;
-
-    indx = str.find_first_of(TOKEN_OBJECT_BEGIN);
-
-    if ( indx == std::string::npos )
-        return p;
-
-    std::istringstream sstr(str.substr(indx));
-    std::istream       buf(sstr.rdbuf());
-
-    if ( clear )
-        _root.clear();
+    if ( _arena == nullptr && _root->getType() == JSON_OBJECT ) {
+        _builder.recycleItems(_root);
+        return;
+    }
 
-    return this->parseObject(buf, _root);
+    this->dispose();
+    _root = JsonCreate<JsonObject>(this->getMemoryResource());
 }
 
-/** Parses the given input stream as the root JsonObject. Returns a
-  * boolean indicating whether the parsing of the stream was
-  * successful. The root JsonObject representing the document can be
-  * retrieved via the getJSON() method.
-  * Set clear to false to not clear the root JsonObject and
-  * essentially add the provided json stream to the current
-  * object.
+
+/** Frees the root and every value of the document. Values allocated
+  * from the arena are released along with it rather than deleted one
+  * by one, unless the tree also holds values allocated elsewhere.
  **/
-bool
-JSON::parse ( std::istream & buf, bool clear )
+void
+JSON::dispose()
 {
-    char c;
-
-    while ( !buf.eof() && (c = buf.peek()) != TOKEN_OBJECT_BEGIN )
-        buf.get();
-
-    if ( clear )
-        _root.clear();
+    if ( _arena != nullptr ) {
+        if ( _root != nullptr && (! _root->inArena() || _arena->adopted()) )
+            delete _root;
+        _arena->release();
+    } else {
+        delete _root;
+    }
 
-    return this->parseObject(buf, _root);
+    _root = nullptr;
 }
 
-// ------------------------------------------------------------------------- //
 
-/** Internal method for parsing the input stream for a JsonObject.
-  * This method is used to recursively parse any and all objects
-  * within the JSON document.
- **/
+/** Returns true if the root is an empty object or array */
 bool
-JSON::parseObject ( std::istream & buf, JsonObject & obj )
+JSON::empty() const
 {
-    bool p = true;
-    char c = buf.get();
-
-    if ( c != TOKEN_OBJECT_BEGIN )
-        return false;
-
-    JsonObject     jobj;
-    JsonArray      jary;
-    JsonNumber     jnum;
-    JsonBoolean    jbool;
-    JsonType       jnul(JSON_NULL);
-    JsonString     jstr, jval;
-    JsonValueType  t;
-    std::string    key;
-
-    while ( ! buf.eof() )
-    {
-        c = buf.peek();
-
-        if ( ::isspace(c) ) {
-            buf.get();
-            continue;
-        }
-        if ( c == TOKEN_OBJECT_END ) {
-            buf.get();
+    switch ( _root->getType() ) {
+        case JSON_OBJECT:
+            return ((const JsonObject*) _root)->empty();
+        case JSON_ARRAY:
+            return ((const JsonArray*) _root)->empty();
+        default:
             break;
-        }
-
-        // key
-        if ( key.empty() ) {
-            p = false;
-            if ( ! this->parseString(buf, jstr) )
-                break;
-            key.assign(jstr.value());
-            if ( ! this->parseAssign(buf) )
-                break;
-            continue;
-        }
-
-        // val
-        t = JSON::ParseValueType(buf);
-
-        switch ( t )
-        {
-            case JSON_OBJECT:
-                if ( this->parseObject(buf, jobj) ) {
-                    obj.insert(key, new JsonObject(jobj));
-                    key.clear();
-                    jobj.clear();
-                    p = true;
-                }
-                break;
-            case JSON_ARRAY:
-                if ( this->parseArray(buf, jary) ) {
-                    obj.insert(key, new JsonArray(jary));
-                    key.clear();
-                    jary.clear();
-                    p = true;
-                }
-                break;
-            case JSON_NUMBER:
-                if ( this->parseNumber(buf, jnum) ) {
-                    obj.insert(key, new JsonNumber(jnum));
-                    key.clear();
-                    p = true;
-                }
-                break;
-            case JSON_STRING:
-                if ( this->parseString(buf, jval) ) {
-                    obj.insert(key, new JsonString(jval));
-                    key.clear();
-                    p = true;
-                }
-                break;
-            case JSON_BOOLEAN:
-                if ( this->parseBoolean(buf, jbool) ) {
-                    obj.insert(key, new JsonBoolean(jbool));
-                    key.clear();
-                    p = true;
-                }
-                break;
-            case JSON_NULL:
-                if ( this->parseLiteral(buf, jnul) ) {
-                    obj.insert(key, new JsonType(jnul));
-                    key.clear();
-                    p = true;
-                }
-                break;
-            default:
-                return false;
-        }
-
-        if ( ! p || ! this->parseSeparator(buf) )
-            return false;
     }
 
-    return p;
+    return false;
 }
 
+// ------------------------------------------------------------------------- //
 
-/** Recursive method for parsing the JSON Array type from the
-  *  given input stream.
+/** Takes the root value out of the document without copying it, leaving
+  * an empty root JsonObject, and the caller then owns and deletes it.
+  * With an arena, the released values remain in the arena, and must not
+  * be kept past the next parse or clear() of the document, or its
+  * destruction; a document may instead be moved to keep its values.
  **/
-bool
-JSON::parseArray ( std::istream & buf, JsonArray & ary )
+JsonType*
+JSON::release()
 {
-    bool p = true;
-    char c = buf.get();
+    JsonType * root = _root;
 
-    if ( c != TOKEN_ARRAY_BEGIN )
-        return false;
+    _root = JsonCreate<JsonObject>(this->getMemoryResource());
 
-    JsonArray     jary;
-    JsonObject    jobj;
-    JsonNumber    jnum;
-    JsonBoolean   jbool;
-    JsonString    jstr;
-    JsonType      jnul(JSON_NULL);
-    JsonValueType t;
-
-    while ( ! buf.eof() )
-    {
-        c = buf.peek();
-
-        if ( ::isspace(c) ) {
-            buf.get();
-            continue;
-        }
-
-        if ( c == TOKEN_ARRAY_END ) {
-            buf.get();
-            break;
-        }
+    return root;
+}
 
-        p = false;
-        t = JSON::ParseValueType(buf);
-
-        switch ( t )
-        {
-            case JSON_OBJECT:
-                if ( this->parseObject(buf, jobj) ) {
-                    ary.insert(new JsonObject(jobj));
-                    jobj.clear();
-                    p = true;
-                }
-                break;
-            case JSON_ARRAY:
-                if ( this->parseArray(buf, jary) ) {
-                    ary.insert(new JsonArray(jary));
-                    jary.clear();
-                    p = true;
-                }
-                break;
-            case JSON_NUMBER:
-                if ( this->parseNumber(buf, jnum) ) {
-                    ary.insert(new JsonNumber(jnum));
-                    p = true;
-                }
-                break;
-            case JSON_STRING:
-                if ( this->parseString(buf, jstr) ) {
-                    ary.insert(new JsonString(jstr));
-                    p = true;
-                }
-                break;
-            case JSON_BOOLEAN:
-                if ( this->parseBoolean(buf, jbool) ) {
-                    ary.insert(new JsonBoolean(jbool));
-                    p = true;
-                }
-                break;
-            case JSON_NULL:
-                if ( this->parseLiteral(buf, jnul) ) {
-                    ary.insert(new JsonType(jnul));
-                    p = true;
-                }
-                break;
-            default:
-                this->setError(buf);
-                return false;
-        }
+// ------------------------------------------------------------------------- //
 
-        if ( ! p || ! this->parseSeparator(buf) )
-            return false;
-    }
+/** Returns the root JsonObject of the document. Throws a runtime_error
+  * if the root of the parsed document is not an object; getRoot() may
+  * be used for documents of any type.
+ **/
+JsonObject&
+JSON::getJSON()
+{
+    if ( _root->getType() != JSON_OBJECT )
+        throw ( std::runtime_error("JSON root is not an object: "
+                    + JSON::TypeToString(_root->getType())) );
 
-    return true;
+    return *((JsonObject*) _root);
 }
 
 
-/** Private method for parsing a JSON String type */
-bool
-JSON::parseString ( std::istream & buf, JsonString & str )
+/** Returns the root JsonArray of the document. Throws a runtime_error
+  * if the root of the parsed document is not an array.
+ **/
+JsonArray&
+JSON::getArray()
 {
-    bool start = false;
-    bool stop  = false;
-    char c;
+    if ( _root->getType() != JSON_ARRAY )
+        throw ( std::runtime_error("JSON root is not an array: "
+                    + JSON::TypeToString(_root->getType())) );
 
-    std::string sstr;
+    return *((JsonArray*) _root);
+}
 
-    while ( ! buf.eof() && ::isspace(buf.peek()) )
-        buf.get();
 
-    while ( ! buf.eof() && ! stop )
-    {
-        c = buf.get();
-
-        if ( c == TOKEN_STRING_SEPARATOR ) {
-            if ( start ) {
-                stop = true;
-            } else {
-                start = true;
-                c = buf.get();
-                if ( c == TOKEN_STRING_SEPARATOR )
-                    stop = true;  // empty string
-            }
-        }
-
-        if ( ! start && ! stop ) {
-            this->setError(buf);
-            return false;
-        }
+/** Enables allocating the values of the document from a JsonArena
+  * owned by the document. All of the objects, arrays, keys and strings
+  * of a parsed document are then bump-allocated from large blocks, and
+  * clear(), a new parse or destruction releases them in one step
+  * instead of deleting each value. Values inserted into the document
+  * may still be allocated with new, though the document is then freed
+  * value by value. Values of the document must not outlive it, or be
+  * kept past clear(). Changing the mode clears the document.
+ **/
+void
+JSON::setUseArena ( bool arena )
+{
+    if ( arena == (_arena != nullptr) )
+        return;
 
-        if ( stop )
-            break;
+    this->dispose();
 
-        if ( c == '\\' )
-        {
-            c = buf.get();
-            switch ( c )
-            {
-                case '"':
-                case '/':
-                case '\\':
-                    sstr.push_back(c);
-                    break;
-                case 'b':
-                    sstr.push_back('\b');
-                    break;
-                case 'f':
-                    sstr.push_back('\f');
-                    break;
-                case 'n':
-                    sstr.push_back('\n');
-                    break;
-                case 'r':
-                    sstr.push_back('\r');
-                    break;
-                case 't':
-                    sstr.push_back('\t');
-                    break;
-                default:   // error
-                    this->setError(buf);
-                    return false;
-                    break;
-            }
-        }
-        else
-        {
-            sstr.push_back(c);
-        }
+    if ( arena ) {
+        _arena = new JsonArena();
+    } else {
+        delete _arena;
+        _arena = nullptr;
     }
 
-    str = JsonString(sstr, JSON_STRING);
-
-    return true;
+    _root = JsonCreate<JsonObject>(this->getMemoryResource());
+    _builder.setMemoryResource(this->getMemoryResource());
 }
 
 
-/** Priavate method for parsing a JSON Number type */
-bool
-JSON::parseNumber ( std::istream & buf, JsonNumber & num )
+/** Sets the memory resource the objects, arrays and strings of the
+  * document allocate their members, keys and payloads from, or the
+  * default resource if nullptr. The JsonTypes themselves are allocated
+  * with new. Setting a resource disables the arena, and clears the
+  * document. The resource must outlive the document.
+ **/
+void
+JSON::setMemoryResource ( std::pmr::memory_resource * mr )
 {
-    const char nums[] = "-+.eE0123456789";
-    std::set<char> numset;
-    std::string    numstr;
-
-    for ( size_t i = 0; i < sizeof(nums); ++i )
-        numset.insert(nums[i]);
-
-    while ( ! buf.eof() && ::isspace(buf.peek()) )
-        buf.get();
+    this->dispose();
 
-    while ( ! buf.eof() && numset.find(buf.peek()) != numset.end() )
-        numstr.push_back(buf.get());
+    delete _arena;
+    _arena = nullptr;
+    _mr    = (mr != nullptr) ? mr : std::pmr::get_default_resource();
 
-    if ( numstr.empty() ) {
-        this->setError(buf);
-        return false;
-    }
-
-    num = JsonNumber(JSON::FromString<double>(numstr), JSON_NUMBER);
-
-    return true;
+    _root  = new JsonObject(JsonAllocator(_mr));
+    _builder.setMemoryResource(_mr);
 }
 
 
-/** Private method for parsing a JSON Boolean literal type */
-bool
-JSON::parseBoolean ( std::istream & buf, JsonBoolean & b )
+/** Sets the number of values freed by clear() or a new parse that the
+  * document keeps for reuse by the next parse, rather than deleting
+  * them. Emptied objects and arrays keep the capacity of their storage,
+  * and strings their buffer, so that repeatedly parsing documents of
+  * the same shape allocates little once the kept values suffice. A
+  * limit of zero, the default, disables reuse. Values are not kept with
+  * an arena, which releases them at once instead.
+ **/
+void
+JSON::setRecycleLimit ( size_t nodes )
 {
-    std::string token;
-    char  c;
+    _builder.setRecycleLimit(nodes);
+}
 
-    while ( ! buf.eof() && ::isspace(buf.peek()) )
-        buf.get();
 
-    while ( ! buf.eof() && ! this->IsSeparator(buf) )
-    {
-        c = buf.get();
-        if ( ::isspace(c) )
-            continue;
-        token.push_back(c);
-    }
+size_t
+JSON::getRecycleLimit() const
+{
+    return _builder.getRecycleLimit();
+}
 
-    if ( token.compare("true") == 0 ) {
-        b = JsonBoolean(true, JSON_BOOLEAN);
-        return true;
-    }
 
-    if ( token.compare("false") == 0 ) {
-        b = JsonBoolean(false, JSON_BOOLEAN);
-        return true;
-    }
+/** Frees the memory the document holds for reuse, being the values
+  * kept for recycling and the buffers of the structural index.
+ **/
+void
+JSON::shrink()
+{
+    _builder.shrink();
+    _index.shrink();
+}
 
-    this->setError(buf);
 
-    return false;
+/** Enables validation of the UTF-8 encoding of all strings. When
+  * enabled, a string holding an ill-formed UTF-8 sequence (overlong
+  * forms, surrogates, code points above U+10FFFF or truncated and
+  * stray continuation bytes) fails the parse at the offending byte.
+  * Validation is disabled by default.
+ **/
+void
+JSON::setValidateUtf8 ( bool validate )
+{
+    _utf8 = validate;
 }
 
 
-/** Private method for parsing a JSON Literal */
 bool
-JSON::parseLiteral ( std::istream & buf, JsonType & item )
+JSON::getValidateUtf8() const
 {
-    std::string token;
-    char  c;
-
-    while ( ! buf.eof() && ::isspace(buf.peek()) )
-        buf.get();
-
-    while ( ! buf.eof() && ! this->IsSeparator(buf) )
-    {
-        c = buf.get();
-        if ( ::isspace(c) )
-            continue;
-        token.push_back(c);
-    }
+    return _utf8;
+}
 
-    if ( item.getType() == JSON_NULL && token.compare("null") == 0 )
-        return true;
+// ------------------------------------------------------------------------- //
 
-    this->setError(buf);
+/** Parses the given string as the root JSON value, which may be of
+  * any type. Returns a boolean indicating whether the parsing of the
+  * string was successful. Only whitespace, and a leading UTF-8 byte
+  * order mark, may surround the value. The root representing the
+  * document can be retrieved via getRoot(), or getJSON() and
+  * getArray() for object and array documents.
+  * Set clear to false to not clear the root and essentially add the
+  * provided json string to the current document: an object document
+  * is merged into a root object and the elements of an array document
+  * are appended to a root array. Any other document replaces the root.
+  * The string is parsed in place and is not copied.
+ **/
+bool
+JSON::parse ( std::string_view str, bool clear )
+{
+    return this->parseDocument(str, clear, false);
+}
 
-    return false;
+/** Parses the given string as the root JSON value using the two-stage
+  * parser. The first stage builds a JsonIndex of the structural
+  * positions in the buffer using vectorized classification. The
+  * second stage builds the document from the index, which it uses to
+  * skip the whitespace between tokens and to size each array, while
+  * strings and numbers are still scanned by the tokenizer. The index
+  * currently costs more than it saves, and parse() is the faster of
+  * the two on the documents measured by jsonbench.
+ **/
+bool
+JSON::parseIndexed ( std::string_view str, bool clear )
+{
+    return this->parseDocument(str, clear, true);
 }
 
+/** Parses the given string, building only the values selected by the
+  * projection and the objects and arrays enclosing them. Everything
+  * else is skipped by a scanner that only balances the brackets and
+  * quotes of each value, so the rest of the document is not validated
+  * beyond that. A document with nothing selected leaves an empty root
+  * object. See JsonProjection for the path syntax.
+ **/
+bool
+JSON::parse ( std::string_view str, const JsonProjection & proj, bool clear )
+{
+    return this->parseDocument(str, clear, false, &proj);
+}
 
-/** Private method for parsing the JSON name assignment operator.
-  * Retrieves the name separator token from the stream
-  * and return true if the character is in fact the correct
-  * seperator.
+/** Parses the given input stream as the root JSON value. Returns a
+  * boolean indicating whether the parsing of the stream was
+  * successful. The root representing the document can be retrieved
+  * via the getRoot() method.
+  * Set clear to false to add the provided json stream to the current
+  * document, as with parsing a string. The remainder of the stream is
+  * read into a contiguous buffer before parsing; prefer parseFile()
+  * for reading files.
  **/
 bool
-JSON::parseAssign ( std::istream & buf )
+JSON::parse ( std::istream & buf, bool clear )
 {
-    char  c;
+    std::string  str;
 
-    while ( ! buf.eof() && ::isspace(buf.peek()) )
-        buf.get();
+    str.assign(std::istreambuf_iterator<char>(buf),
+               std::istreambuf_iterator<char>());
 
-    c = buf.get();
+    return this->parse(std::string_view(str), clear);
+}
 
-    if ( c == TOKEN_NAME_SEPARATOR )
-        return true;
+/** Parses the given file as the root JSON value. The file is memory
+  * mapped and parsed in place, rather than read through a stream, and
+  * the mapping is released once the document is built. Returns false
+  * if the file could not be mapped, with the reason available via
+  * getErrorStr(), or if it could not be parsed.
+ **/
+bool
+JSON::parseFile ( const std::string & filename, bool clear )
+{
+    JsonMappedFile  file;
 
-    this->setError(buf);
+    if ( ! file.open(filename) ) {
+        _errpos = 0;
+        _errstr = file.getErrorStr();
+        if ( clear )
+            this->clear();
+        return false;
+    }
 
-    return false;
+    return this->parseDocument(file.view(), clear, false);
 }
 
+// ------------------------------------------------------------------------- //
 
-/**  Method for parsing the field or value operator from
-  *  the given input stream.
+/** Internal method for parsing the input buffer as a complete
+  * document with the JsonTreeBuilder. An object or array document
+  * matching the type of the root is parsed in place, reusing the root,
+  * otherwise the parsed value replaces the root.
  **/
 bool
-JSON::parseSeparator ( std::istream & buf )
+JSON::parseDocument ( std::string_view str, bool clear, bool indexed,
+                      const JsonProjection * proj )
 {
-    char  c;
+    JsonType * root;
+    bool       p;
+
+    if ( clear ) {
+        if ( _arena != nullptr )
+            this->clear();
+        else
+            _builder.recycleItems(_root);
+    }
 
-    while ( ! buf.eof() && (::isspace(buf.peek()) || buf.peek() == '\n') )
-        buf.get();
+    _builder.reset(_root);
+    _parser.setValidateUtf8(_utf8);
 
-    if ( (c = buf.peek()) == TOKEN_VALUE_SEPARATOR ) {
-        buf.get();
-        return true;
+    if ( proj != nullptr )
+        p = _parser.parseProjected(str, *proj);
+    else if ( indexed )
+        p = _parser.parseIndexed(str, _index);
+    else
+        p = _parser.parse(str);
+
+    if ( ! p ) {
+        _errpos = _parser.getErrorPos();
+        _errstr = _parser.getErrorStr();
+        _builder.reset();
+        if ( clear )
+            this->clear();
+        return false;
     }
 
-    if ( c == TOKEN_ARRAY_END || c == TOKEN_OBJECT_END )
+    if ( (root = _builder.release()) == nullptr ) {
+        if ( clear )
+            this->clear();  // nothing projected
         return true;
+    }
 
-    this->setError(buf);
+    if ( root != _root ) {
+        _builder.recycle(_root);
+        _root = root;
+    }
 
-    return false;
+    return true;
 }
 
+// ------------------------------------------------------------------------- //
 
-/**  Static function to determine whether the next character in the input
-  *  stream is a valid JSON value or end separator.
+/**  Static function to determine whether the given character
+  *  is a valid JSON value or end separator.
  **/
 bool
-JSON::IsSeparator ( std::istream & buf )
+JSON::IsSeparator ( char c )
 {
-    char c = buf.peek();
-
     if ( c == TOKEN_VALUE_SEPARATOR || c == TOKEN_ARRAY_END || c == TOKEN_OBJECT_END )
         return true;
 
@@ -630,80 +653,23 @@ JSON::IsSeparator ( std::istream & buf )
 }
 
 
-/**  Method for determining the value type of the upcoming value
-  *  in the input stream.
+/**  Static function to determine whether the given character is
+  *  JSON whitespace.
  **/
-json_t
-JSON::ParseValueType ( std::istream & buf )
+bool
+JSON::IsSpace ( char c )
 {
-    json_t t;
-    char   c;
-
-    while ( ! buf.eof() && ::isspace(buf.peek()) )
-        buf.get();
-
-    c = buf.peek();
-
-    switch ( c ) {
-        case TOKEN_ARRAY_BEGIN:
-            t = JSON_ARRAY;
-            break;
-        case TOKEN_OBJECT_BEGIN:
-            t = JSON_OBJECT;
-            break;
-        case TOKEN_STRING_SEPARATOR:
-            t = JSON_STRING;
-            break;
-        case '-':
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-            t = JSON_NUMBER;
-            break;
-        case 't':
-            t = JSON_BOOLEAN;
-            break;
-        case 'f':
-            t = JSON_BOOLEAN;
-            break;
-        case 'n':
-        default:
-            t = JSON_NULL;
-            break;
-    }
-
-    return t;
+    return JsonTokenizer::IsSpace(c);
 }
 
 
-/** Sets the error string, recording the position within the stream
-  * where the parse error occurred.
+/**  Static function to determine whether the given character is
+  *  a decimal digit.
  **/
-void
-JSON::setError ( std::istream & buf )
+bool
+JSON::IsDigit ( char c )
 {
-    std::ios::pos_type pos;
-
-    _errpos  = buf.tellg();
-    pos      = 5;
-    _errstr.clear();
-
-    if ( _errpos < pos )
-        buf.seekg(0);
-    else
-        buf.seekg(_errpos - pos);
-
-    while ( ! buf.eof() && buf.tellg() < (_errpos + _errlen) )
-        _errstr.push_back(buf.get());
-
-    return;
+    return JsonTokenizer::IsDigit(c);
 }
 
 
@@ -789,6 +755,29 @@ JSON::ToString ( const JsonType * item, bool asJson )
 }
 
 
+/**  Returns the name of the vectorized kernel implementation used by
+  *  the parser and serializer. The best implementation supported by
+  *  the CPU is selected at first use.
+ **/
+std::string
+JSON::ActiveImplementation()
+{
+    return std::string(JsonKernels::Active().name);
+}
+
+
+/**  Forces the kernel implementation used by the parser and serializer,
+  *  one of "scalar", "sse4.2", "avx2", "avx512" or "auto" to restore
+  *  the detected default. Returns false if the implementation is not
+  *  supported by the CPU. Affects parses started after the call.
+ **/
+bool
+JSON::SetImplementation ( const std::string & name )
+{
+    return JsonKernels::Select(name);
+}
+
+
 /**  Returns a string of the tcajson library version */
 std::string
 JSON::Version()
@@ -799,6 +788,69 @@ JSON::Version()
 }
 
 
+/** Static method for appending the UTF-8 encoding of the given
+  * unicode code point to the string.
+ **/
+void
+JSON::AppendUtf8 ( std::string & str, uint32_t cp )
+{
+    if ( cp < 0x80 ) {
+        str.push_back((char) cp);
+    } else if ( cp < 0x800 ) {
+        str.push_back((char)(0xC0 | (cp >> 6)));
+        str.push_back((char)(0x80 | (cp & 0x3F)));
+    } else if ( cp < 0x10000 ) {
+        str.push_back((char)(0xE0 | (cp >> 12)));
+        str.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        str.push_back((char)(0x80 | (cp & 0x3F)));
+    } else {
+        str.push_back((char)(0xF0 | (cp >> 18)));
+        str.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+        str.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+        str.push_back((char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+
+/** Static method returning a deep copy of the given JsonType. The
+  * objects, arrays and strings of the copy use the given allocator,
+  * and are created in its resource when that is a JsonArena.
+ **/
+JsonType*
+JSON::Copy ( const JsonType * item, const JsonAllocator & alloc )
+{
+    switch ( item->getType() ) {
+        case JSON_OBJECT:
+            return JsonCreate<JsonObject>(alloc, *((const JsonObject*) item));
+        case JSON_ARRAY:
+            return JsonCreate<JsonArray>(alloc, *((const JsonArray*) item));
+        case JSON_NUMBER:
+            return JsonCreate<JsonNumber>(alloc, *((const JsonNumber*) item));
+        case JSON_STRING:
+            return JsonCreate<JsonString>(alloc, *((const JsonString*) item));
+        case JSON_BOOLEAN:
+            return JsonCreate<JsonBoolean>(alloc, *((const JsonBoolean*) item));
+        case JSON_NULL:
+        default:
+            break;
+    }
+
+    return JsonCreate<JsonType>(alloc, JSON_NULL);
+}
+
+
+/** Static method for validating that the given string is well-formed
+  * UTF-8, using the vectorized validation kernel.
+ **/
+bool
+JSON::IsValidUtf8 ( std::string_view str )
+{
+    const char * end = str.data() + str.size();
+
+    return JsonKernels::Active().validUtf8(str.data(), end) == end;
+}
+
+
 /** Static method for validating the given character is a valid
   * input character. This includes checking for unicode chars
  **/
@@ -0,0 +1,134 @@
+/**
+  * @file JsonArena.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONARENA_CPP_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "JsonArena.h"
+
+
+namespace tcajson {
+
+
+JsonArena::JsonArena ( size_t blocksz )
+    : _pos(nullptr),
+      _end(nullptr),
+      _blocksz(std::max(blocksz, (size_t) 1024)),
+      _size(0),
+      _capacity(0),
+      _adopted(false)
+{}
+
+
+JsonArena::~JsonArena()
+{
+    this->shrink();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Releases all memory allocated from the arena at once, without
+  * destroying anything allocated from it. When more than one block is
+  * held, they are replaced by a single block of the same capacity.
+ **/
+void
+JsonArena::release()
+{
+    if ( _blocks.size() > 1 ) {
+        size_t  cap = _capacity;
+
+        this->shrink();
+
+        _blocks.push_back(Block{ (char*) ::operator new(cap), cap });
+        _capacity = cap;
+    }
+
+    if ( ! _blocks.empty() ) {
+        _pos = _blocks.front().data;
+        _end = _pos + _blocks.front().size;
+    }
+
+    _size    = 0;
+    _adopted = false;
+}
+
+
+/** Releases all memory allocated from the arena and frees its blocks */
+void
+JsonArena::shrink()
+{
+    for ( Block & b : _blocks )
+        ::operator delete(b.data);
+
+    _blocks.clear();
+
+    _pos      = nullptr;
+    _end      = nullptr;
+    _size     = 0;
+    _capacity = 0;
+    _adopted  = false;
+}
+
+// ------------------------------------------------------------------------- //
+
+void*
+JsonArena::do_allocate ( size_t bytes, size_t align )
+{
+    uintptr_t  p = ((uintptr_t) _pos + align - 1) & ~((uintptr_t) align - 1);
+
+    if ( _pos == nullptr || p + bytes > (uintptr_t) _end )
+        return this->grow(bytes, align);
+
+    _pos   = (char*) p + bytes;
+    _size += bytes;
+
+    return (void*) p;
+}
+
+
+/** Adds a block large enough for the given allocation, doubling the
+  * capacity of the arena up to the maximum block size.
+ **/
+void*
+JsonArena::grow ( size_t bytes, size_t align )
+{
+    size_t  sz = std::clamp(_capacity, _blocksz, std::max(_blocksz, (size_t) TCAJSON_ARENA_MAXBLOCKSZ));
+
+    sz = std::max(sz, bytes + align);
+
+    _blocks.push_back(Block{ (char*) ::operator new(sz), sz });
+
+    _capacity += sz;
+    _pos       = _blocks.back().data;
+    _end       = _pos + sz;
+
+    return this->do_allocate(bytes, align);
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONARENA_CPP_
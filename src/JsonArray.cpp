@@ -24,6 +24,7 @@
 #define _TCAJSON_JSONARRAY_CPP_
 
 #include "JsonArray.h"
+#include "JsonArena.h"
 #include "JSON.h"
 
 
@@ -38,6 +39,15 @@ JsonArray::JsonArray()
 {}
 
 
+/**  Constructs an empty JsonArray whose storage is allocated with
+  *  the given allocator.
+ **/
+JsonArray::JsonArray ( const allocator_type & alloc )
+    : JsonType(JSON_ARRAY),
+      _items(alloc)
+{}
+
+
 /**  JsonArray copy constructor */
 JsonArray::JsonArray ( const JsonArray & ary )
     : JsonType(JSON_ARRAY)
@@ -45,6 +55,40 @@ JsonArray::JsonArray ( const JsonArray & ary )
     *this = ary;
 }
 
+/**  JsonArray copy constructor using the given allocator */
+JsonArray::JsonArray ( const JsonArray & ary, const allocator_type & alloc )
+    : JsonType(JSON_ARRAY),
+      _items(alloc)
+{
+    *this = ary;
+}
+
+/**  JsonArray move constructor, taking the elements of 'ary' along
+  *  with its allocator.
+ **/
+JsonArray::JsonArray ( JsonArray && ary ) noexcept
+    : JsonType(JSON_ARRAY),
+      _items(std::move(ary._items))
+{}
+
+/**  JsonArray move constructor using the given allocator. The storage
+  *  is taken when the allocators are equal, otherwise the elements are
+  *  copied with the given allocator, as the source may release its
+  *  memory, and the elements of 'ary' are deleted.
+ **/
+JsonArray::JsonArray ( JsonArray && ary, const allocator_type & alloc )
+    : JsonType(JSON_ARRAY),
+      _items(alloc)
+{
+    JsonArena * arena = dynamic_cast<JsonArena*>(alloc.resource());
+    bool        same  = (alloc == ary.get_allocator());
+
+    this->moveItems(ary);
+
+    if ( same && arena != nullptr && ! ary.inArena() && ! _items.empty() )
+        arena->adopt();
+}
+
 /** JsonArray destructor */
 JsonArray::~JsonArray()
 {
@@ -53,48 +97,74 @@ JsonArray::~JsonArray()
 
 // ------------------------------------------------------------------------- //
 
-/** Assignment operator for a JsonArray. */
+/** Assignment operator for a JsonArray. The elements of 'ary' are
+  * copied with the allocator of this array before the current elements
+  * are deleted, so an array may be assigned one of its own elements.
+ **/
 JsonArray&
 JsonArray::operator= ( const JsonArray & ary )
 {
     if ( this == &ary )
         return *this;
 
-    this->_items.clear();
-    this->_type  = ary._type;
+    ArrayItems  items(_items.get_allocator());
+
+    items.reserve(ary.size());
 
     JsonArray::const_iterator  jIter;
     for ( jIter = ary.begin(); jIter != ary.end(); ++jIter )
-    {
-        json_t  t = (*jIter)->getType();
-
-        switch ( t ) {
-            case JSON_OBJECT:
-                this->insert(new JsonObject(*(JsonObject*)*jIter));
-                break;
-            case JSON_ARRAY:
-                this->insert(new JsonArray(*(JsonArray*)*jIter));
-                break;
-            case JSON_NUMBER:
-                this->insert(new JsonNumber(*(JsonNumber*)*jIter));
-                break;
-            case JSON_STRING:
-                this->insert(new JsonString(*(JsonString*)*jIter));
-                break;
-            case JSON_BOOLEAN:
-                this->insert(new JsonBoolean(*(JsonBoolean*)*jIter));
-                break;
-            case JSON_NULL:
-                this->insert(new JsonType(JSON_NULL));
-                break;
-            default:
-                break;
-        }
-    }
+        items.push_back(JSON::Copy(*jIter, _items.get_allocator()));
+
+    this->_type  = ary._type;
+    this->clear();
+    this->_items.swap(items);
 
     return *this;
 }
 
+/** Move assignment for a JsonArray. The elements of 'ary' are taken
+  * before the current elements are deleted, so an array may be assigned
+  * one of its own elements, and 'ary' is left empty.
+ **/
+JsonArray&
+JsonArray::operator= ( JsonArray && ary )
+{
+    if ( this == &ary )
+        return *this;
+
+    JsonArray  moved(std::move(ary), _items.get_allocator());
+
+    this->clear();
+    this->_items.swap(moved._items);
+
+    return *this;
+}
+
+/** Takes the elements of 'ary' into this empty array, swapping the
+  * storage when the allocators are equal, and otherwise copying each
+  * element with the allocator of this array and emptying 'ary'.
+ **/
+void
+JsonArray::moveItems ( JsonArray & ary )
+{
+    if ( _items.get_allocator() == ary._items.get_allocator() ) {
+        _items.swap(ary._items);
+        return;
+    }
+
+    _items.reserve(ary.size());
+
+    JsonArray::iterator  jIter;
+    for ( jIter = ary.begin(); jIter != ary.end(); ++jIter ) {
+        JsonType * item = nullptr;
+        if ( *jIter )
+            item = JSON::Copy(*jIter, _items.get_allocator());
+        _items.push_back(item);
+    }
+
+    ary.clear();
+}
+
 // ------------------------------------------------------------------------- //
 
 /** Index operator for retrieving a JsonType at a given location. */
@@ -117,16 +187,36 @@ JsonArray::operator[] ( JsonArray::size_type index ) const
 JsonArray::iterator
 JsonArray::insert ( JsonType * item )
 {
-    return _items.insert(_items.end(), item);
+    if ( _arena && item != nullptr && ! item->inArena() )
+        ((JsonArena*) _items.get_allocator().resource())->adopt();
+
+    _items.push_back(item);
+    return std::prev(_items.end());
 }
 
 /** Inserts the provided JsonType into the array at the give position. */
 JsonArray::iterator
 JsonArray::insert ( JsonType * item, JsonArray::iterator at )
 {
+    if ( _arena && item != nullptr && ! item->inArena() )
+        ((JsonArena*) _items.get_allocator().resource())->adopt();
+
     return _items.insert(at, item);
 }
 
+/** Appends the item to the array, taking ownership of it once
+  * inserted.
+ **/
+JsonArray::iterator
+JsonArray::insert ( std::unique_ptr<JsonType> item )
+{
+    JsonArray::iterator  iter = this->insert(item.get());
+
+    item.release();
+
+    return iter;
+}
+
 // ------------------------------------------------------------------------- //
 
 /** Erases the JsonType at the given iterator position */
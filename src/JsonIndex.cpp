@@ -0,0 +1,278 @@
+/**
+  * @file JsonIndex.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONINDEX_CPP_
+
+#include <cstring>
+
+#include "JsonIndex.h"
+#include "JsonKernels.h"
+#include "JsonType.hpp"
+
+
+namespace tcajson {
+
+
+#define TCAJSON_BLOCKLEN  64
+
+
+/* Returns the mask of characters escaped by a backslash. The 'carry'
+ * is set when the last byte of the block escapes the first byte of the
+ * next block. Blocks without a backslash take the fast path.
+ */
+static inline uint64_t
+FindEscaped ( uint64_t backslash, uint64_t & carry )
+{
+    uint64_t escaped = carry;
+    uint64_t bs      = backslash & ~carry;
+
+    carry = 0;
+
+    while ( bs ) {
+        int i = __builtin_ctzll(bs);
+
+        if ( i == 63 ) {
+            carry = 1;
+        } else {
+            escaped |= (uint64_t) 1 << (i + 1);
+            bs      &= ~((uint64_t) 1 << (i + 1));
+        }
+        bs &= bs - 1;
+    }
+
+    return escaped;
+}
+
+
+/* Computes the running xor of all bits below and including each bit,
+ * which turns a mask of quotes into a mask of the string interiors.
+ */
+static inline uint64_t
+PrefixXor ( uint64_t x )
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// ------------------------------------------------------------------------- //
+
+JsonIndex::JsonIndex()
+    : _errpos(0)
+{}
+
+JsonIndex::~JsonIndex()
+{}
+
+// ------------------------------------------------------------------------- //
+
+/** Builds the structural index of the provided buffer. Returns false
+  * if the buffer ends within a string or is too large to be indexed,
+  * in which case getErrorPos() reports the offending position.
+ **/
+bool
+JsonIndex::build ( std::string_view str )
+{
+    const JsonKernels & kernels = JsonKernels::Active();
+
+    const char * buf   = str.data();
+    size_t       len   = str.size();
+    uint64_t     escc  = 0;   // escape carry
+    uint64_t     instr = 0;   // all ones while inside a string
+    uint64_t     prevs = 0;   // last byte of the previous block was a scalar
+    size_t       strpos = 0;
+    char         tail[TCAJSON_BLOCKLEN];
+
+    _positions.clear();
+    _sizes.clear();
+    _stack.clear();
+    _errpos = 0;
+
+    if ( len > UINT32_MAX ) {
+        _errpos = UINT32_MAX;
+        return false;
+    }
+
+    _positions.reserve(len / 8);
+
+    for ( size_t off = 0; off < len; off += TCAJSON_BLOCKLEN )
+    {
+        const char *    p = buf + off;
+        JsonBlockMasks  m;
+
+        if ( len - off < TCAJSON_BLOCKLEN ) {
+            std::memset(tail, TOKEN_WS, TCAJSON_BLOCKLEN);
+            std::memcpy(tail, p, len - off);
+            p = tail;
+        }
+
+        kernels.classify(p, m);
+
+        uint64_t escaped = 0;
+        if ( m.backslash || escc )
+            escaped = FindEscaped(m.backslash, escc);
+
+        uint64_t quote   = m.quote & ~escaped;
+        uint64_t inside  = PrefixXor(quote) ^ instr;
+        uint64_t outside = ~inside;
+
+        // remember where the last string opened for error reporting
+        if ( quote & inside )
+            strpos = off + 63 - __builtin_clzll(quote & inside);
+
+        instr = (uint64_t)((int64_t) inside >> 63);
+
+        uint64_t op      = m.op & outside;
+        uint64_t scalar  = ~(m.op | m.space | quote) & outside;
+        uint64_t follows = (scalar << 1) | prevs;
+        uint64_t starts  = scalar & ~follows;
+
+        prevs = scalar >> 63;
+
+        uint64_t structural = op | (quote & inside) | starts;
+
+        if ( structural == 0 )
+            continue;
+
+        size_type  n   = _positions.size();
+        size_type  cnt = __builtin_popcountll(structural);
+
+        _positions.resize(n + cnt);
+
+        uint32_t * out = _positions.data() + n;
+
+        if ( op )
+            this->countArrays(p, op, structural, n);
+
+        while ( structural ) {
+            *out++ = (uint32_t)(off + __builtin_ctzll(structural));
+            structural &= structural - 1;
+        }
+    }
+
+    if ( instr ) {
+        _errpos = strpos;
+        return false;
+    }
+
+    return true;
+}
+
+
+/** Counts the elements of the arrays from the operators of a block,
+  * where 'n' is the index of the first structural position of the
+  * block. Separators directly within an array are counted, plus one
+  * unless the array closes at the position after it opens, so that
+  * the index of an operator is only computed for square brackets. The
+  * counts are only a sizing hint, so unbalanced brackets are left for
+  * the parser to report.
+ **/
+void
+JsonIndex::countArrays ( const char * p, uint64_t op, uint64_t structural,
+                         size_type n )
+{
+    while ( op )
+    {
+        int       i   = __builtin_ctzll(op);
+        uint32_t  idx;
+
+        op &= op - 1;
+
+        switch ( p[i] ) {
+            case TOKEN_NAME_SEPARATOR:
+                break;
+
+            case TOKEN_VALUE_SEPARATOR:
+                if ( ! _stack.empty() && _stack.back().first != UINT32_MAX )
+                    ++_sizes[_stack.back().first];
+                break;
+
+            case TOKEN_ARRAY_BEGIN:
+                idx = n + __builtin_popcountll(structural & (((uint64_t) 1 << i) - 1));
+                _stack.emplace_back(_sizes.size(), idx);
+                _sizes.push_back(0);
+                break;
+
+            case TOKEN_OBJECT_BEGIN:
+                _stack.emplace_back(UINT32_MAX, 0);
+                break;
+
+            case TOKEN_ARRAY_END:
+                if ( _stack.empty() )
+                    break;
+                idx = n + __builtin_popcountll(structural & (((uint64_t) 1 << i) - 1));
+                if ( _stack.back().first != UINT32_MAX && idx != _stack.back().second + 1 )
+                    ++_sizes[_stack.back().first];
+                _stack.pop_back();
+                break;
+
+            case TOKEN_OBJECT_END:
+                if ( ! _stack.empty() )
+                    _stack.pop_back();
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+
+void
+JsonIndex::clear()
+{
+    _positions.clear();
+    _sizes.clear();
+    _errpos = 0;
+}
+
+
+/** Clears the index and frees its buffers */
+void
+JsonIndex::shrink()
+{
+    this->clear();
+
+    Positions().swap(_positions);
+    Positions().swap(_sizes);
+    Containers().swap(_stack);
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Returns the name of the classification kernel in use */
+std::string
+JsonIndex::Implementation()
+{
+    return std::string(JsonKernels::Active().name);
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONINDEX_CPP_
@@ -0,0 +1,710 @@
+/**
+  * @file JsonKernels.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONKERNELS_CPP_
+
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+# define TCAJSON_X86  1
+# include <immintrin.h>
+# define TCAJSON_TARGET(isa)  __attribute__((target(isa)))
+#endif
+
+#include "JsonKernels.h"
+#include "JsonType.hpp"
+
+
+namespace tcajson {
+
+
+/* Per byte classification used by the scalar kernels */
+enum JsonByteClass : uint8_t {
+    JSON_BC_NONE      = 0,
+    JSON_BC_QUOTE     = 1,
+    JSON_BC_BACKSLASH = 2,
+    JSON_BC_SPACE     = 3,
+    JSON_BC_OP        = 4
+};
+
+
+static constexpr std::array<uint8_t, 256> JsonByteTable = []
+{
+    std::array<uint8_t, 256> tbl{};
+
+    tbl[(uint8_t) TOKEN_STRING_SEPARATOR] = JSON_BC_QUOTE;
+    tbl[(uint8_t) '\\']                   = JSON_BC_BACKSLASH;
+    tbl[(uint8_t) TOKEN_WS]               = JSON_BC_SPACE;
+    tbl[(uint8_t) '\t']                   = JSON_BC_SPACE;
+    tbl[(uint8_t) '\n']                   = JSON_BC_SPACE;
+    tbl[(uint8_t) '\r']                   = JSON_BC_SPACE;
+    tbl[(uint8_t) TOKEN_ARRAY_BEGIN]      = JSON_BC_OP;
+    tbl[(uint8_t) TOKEN_ARRAY_END]        = JSON_BC_OP;
+    tbl[(uint8_t) TOKEN_OBJECT_BEGIN]     = JSON_BC_OP;
+    tbl[(uint8_t) TOKEN_OBJECT_END]       = JSON_BC_OP;
+    tbl[(uint8_t) TOKEN_NAME_SEPARATOR]   = JSON_BC_OP;
+    tbl[(uint8_t) TOKEN_VALUE_SEPARATOR]  = JSON_BC_OP;
+
+    return tbl;
+}();
+
+// ------------------------------------------------------------------------- //
+//  scalar
+
+static void
+ClassifyScalar ( const char * p, JsonBlockMasks & m )
+{
+    uint64_t  masks[5] = { 0, 0, 0, 0, 0 };
+
+    for ( int i = 0; i < 64; ++i )
+        masks[JsonByteTable[(uint8_t) p[i]]] |= (uint64_t) 1 << i;
+
+    m.quote     = masks[JSON_BC_QUOTE];
+    m.backslash = masks[JSON_BC_BACKSLASH];
+    m.space     = masks[JSON_BC_SPACE];
+    m.op        = masks[JSON_BC_OP];
+}
+
+
+static const char*
+SkipSpaceScalar ( const char * p, const char * end )
+{
+    while ( p < end && JsonByteTable[(uint8_t) *p] == JSON_BC_SPACE )
+        ++p;
+    return p;
+}
+
+
+static const char*
+ScanStringScalar ( const char * p, const char * end )
+{
+    while ( p < end ) {
+        if ( *p == TOKEN_STRING_SEPARATOR || *p == '\\' || (uint8_t) *p < 0x20 )
+            break;
+        ++p;
+    }
+    return p;
+}
+
+
+/* Well-formed UTF-8 byte ranges (Unicode Table 3-7), indexed by the
+ * lead byte: the number of continuation bytes and the valid range of
+ * the first continuation byte. Invalid lead bytes have a length of 0.
+ */
+struct JsonUtf8Range {
+    uint8_t  len;
+    uint8_t  lo;
+    uint8_t  hi;
+};
+
+static constexpr std::array<JsonUtf8Range, 256> JsonUtf8Table = []
+{
+    std::array<JsonUtf8Range, 256> tbl{};
+
+    for ( int c = 0xC2; c <= 0xDF; ++c )
+        tbl[c] = { 1, 0x80, 0xBF };
+    for ( int c = 0xE0; c <= 0xEF; ++c )
+        tbl[c] = { 2, 0x80, 0xBF };
+    for ( int c = 0xF0; c <= 0xF4; ++c )
+        tbl[c] = { 3, 0x80, 0xBF };
+
+    tbl[0xE0] = { 2, 0xA0, 0xBF };  // overlong
+    tbl[0xED] = { 2, 0x80, 0x9F };  // surrogates
+    tbl[0xF0] = { 3, 0x90, 0xBF };  // overlong
+    tbl[0xF4] = { 3, 0x80, 0x8F };  // above U+10FFFF
+
+    return tbl;
+}();
+
+
+static const char*
+ValidUtf8Scalar ( const char * p, const char * end )
+{
+    uint64_t  w;
+
+    while ( p < end )
+    {
+        if ( end - p >= 8 ) {
+            std::memcpy(&w, p, sizeof(w));
+            if ( (w & 0x8080808080808080ULL) == 0 ) {
+                p += 8;
+                continue;
+            }
+        }
+
+        uint8_t  c = (uint8_t) *p;
+
+        if ( c < 0x80 ) {
+            ++p;
+            continue;
+        }
+
+        const JsonUtf8Range & r = JsonUtf8Table[c];
+
+        if ( r.len == 0 || end - p <= r.len )
+            return p;
+        if ( (uint8_t) p[1] < r.lo || (uint8_t) p[1] > r.hi )
+            return p;
+
+        for ( int i = 2; i <= r.len; ++i ) {
+            if ( ((uint8_t) p[i] & 0xC0) != 0x80 )
+                return p;
+        }
+
+        p += r.len + 1;
+    }
+
+    return p;
+}
+
+// ------------------------------------------------------------------------- //
+
+#if defined(TCAJSON_X86)
+
+/* Lookup tables of the vectorized UTF-8 validation (Keiser and Lemire,
+ * "Validating UTF-8 In Less Than One Instruction Per Byte"). Each pair
+ * of adjacent bytes is classified by the high and low nibble of the
+ * first byte and the high nibble of the second, and the three lookups
+ * are and'ed together; any remaining bit is an error, except for the
+ * expected third and fourth bytes of a sequence.
+ */
+enum JsonUtf8Error : uint8_t {
+    UTF8_TOO_SHORT      = 1 << 0,
+    UTF8_TOO_LONG       = 1 << 1,
+    UTF8_OVERLONG_3     = 1 << 2,
+    UTF8_TOO_LARGE      = 1 << 3,
+    UTF8_SURROGATE      = 1 << 4,
+    UTF8_OVERLONG_2     = 1 << 5,
+    UTF8_TOO_LARGE_1000 = 1 << 6,
+    UTF8_OVERLONG_4     = 1 << 6,
+    UTF8_TWO_CONTS      = 1 << 7,
+    UTF8_CARRY          = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS
+};
+
+alignas(16) static const uint8_t  Utf8Byte1High[16] = {
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+};
+
+alignas(16) static const uint8_t  Utf8Byte1Low[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+};
+
+alignas(16) static const uint8_t  Utf8Byte2High[16] = {
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3
+        | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+};
+
+/* The largest value allowed in each of the last three bytes of a block
+ * without the block ending within a multi-byte sequence.
+ */
+alignas(16) static const uint8_t  Utf8MaxTail[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+
+// ------------------------------------------------------------------------- //
+//  sse4.2
+
+TCAJSON_TARGET("sse4.2") static inline uint64_t
+MatchSSE ( const __m128i v[4], char c )
+{
+    const __m128i  cv = _mm_set1_epi8(c);
+    uint64_t r0 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v[0], cv));
+    uint64_t r1 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v[1], cv));
+    uint64_t r2 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v[2], cv));
+    uint64_t r3 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v[3], cv));
+
+    return r0 | (r1 << 16) | (r2 << 32) | (r3 << 48);
+}
+
+TCAJSON_TARGET("sse4.2") static void
+ClassifySSE ( const char * p, JsonBlockMasks & m )
+{
+    __m128i v[4];
+
+    for ( int i = 0; i < 4; ++i )
+        v[i] = _mm_loadu_si128((const __m128i*)(p + (i * 16)));
+
+    m.quote     = MatchSSE(v, TOKEN_STRING_SEPARATOR);
+    m.backslash = MatchSSE(v, '\\');
+    m.space     = MatchSSE(v, TOKEN_WS)  | MatchSSE(v, '\t')
+                | MatchSSE(v, '\n')      | MatchSSE(v, '\r');
+    m.op        = MatchSSE(v, TOKEN_ARRAY_BEGIN)    | MatchSSE(v, TOKEN_ARRAY_END)
+                | MatchSSE(v, TOKEN_OBJECT_BEGIN)   | MatchSSE(v, TOKEN_OBJECT_END)
+                | MatchSSE(v, TOKEN_NAME_SEPARATOR) | MatchSSE(v, TOKEN_VALUE_SEPARATOR);
+}
+
+TCAJSON_TARGET("sse4.2") static const char*
+SkipSpaceSSE ( const char * p, const char * end )
+{
+    const __m128i sp = _mm_set1_epi8(TOKEN_WS);
+    const __m128i tb = _mm_set1_epi8('\t');
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+
+    while ( end - p >= 16 ) {
+        __m128i  v  = _mm_loadu_si128((const __m128i*) p);
+        __m128i  ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tb)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+        uint32_t m  = ~(uint32_t) _mm_movemask_epi8(ws) & 0xFFFF;
+
+        if ( m )
+            return p + __builtin_ctz(m);
+        p += 16;
+    }
+
+    return SkipSpaceScalar(p, end);
+}
+
+TCAJSON_TARGET("sse4.2") static const char*
+ScanStringSSE ( const char * p, const char * end )
+{
+    const __m128i qt = _mm_set1_epi8(TOKEN_STRING_SEPARATOR);
+    const __m128i bs = _mm_set1_epi8('\\');
+    const __m128i cc = _mm_set1_epi8(0x1F);
+
+    while ( end - p >= 16 ) {
+        __m128i  v = _mm_loadu_si128((const __m128i*) p);
+        __m128i  r = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, qt), _mm_cmpeq_epi8(v, bs)),
+                                  _mm_cmpeq_epi8(_mm_max_epu8(v, cc), cc));
+        uint32_t m = (uint32_t) _mm_movemask_epi8(r);
+
+        if ( m )
+            return p + __builtin_ctz(m);
+        p += 16;
+    }
+
+    return ScanStringScalar(p, end);
+}
+
+/* Returns the error bits of the 16 bytes 'v' following 'prev' */
+TCAJSON_TARGET("sse4.2") static inline __m128i
+Utf8ErrorsSSE ( __m128i v, __m128i prev )
+{
+    const __m128i nib = _mm_set1_epi8(0x0F);
+    const __m128i t1  = _mm_load_si128((const __m128i*) Utf8Byte1High);
+    const __m128i t2  = _mm_load_si128((const __m128i*) Utf8Byte1Low);
+    const __m128i t3  = _mm_load_si128((const __m128i*) Utf8Byte2High);
+
+    __m128i  prev1 = _mm_alignr_epi8(v, prev, 15);
+    __m128i  prev2 = _mm_alignr_epi8(v, prev, 14);
+    __m128i  prev3 = _mm_alignr_epi8(v, prev, 13);
+
+    __m128i  b1h = _mm_shuffle_epi8(t1, _mm_and_si128(_mm_srli_epi16(prev1, 4), nib));
+    __m128i  b1l = _mm_shuffle_epi8(t2, _mm_and_si128(prev1, nib));
+    __m128i  b2h = _mm_shuffle_epi8(t3, _mm_and_si128(_mm_srli_epi16(v, 4), nib));
+    __m128i  sc  = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+
+    __m128i  m23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80))),
+                                _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80))));
+
+    return _mm_xor_si128(sc, _mm_and_si128(m23, _mm_set1_epi8((char) 0x80)));
+}
+
+TCAJSON_TARGET("sse4.2") static const char*
+ValidUtf8SSE ( const char * p, const char * end )
+{
+    const char *  beg  = p;
+    const __m128i maxt = _mm_loadu_si128((const __m128i*)(Utf8MaxTail + 16));
+
+    __m128i  prev = _mm_setzero_si128();
+    __m128i  err  = _mm_setzero_si128();
+    __m128i  inc  = _mm_setzero_si128();
+    char     tail[16];
+
+    if ( end - p < 16 )
+        return ValidUtf8Scalar(p, end);
+
+    for ( ; p < end; p += 16 )
+    {
+        __m128i  v;
+
+        if ( end - p >= 16 ) {
+            v = _mm_loadu_si128((const __m128i*) p);
+        } else {
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, p, end - p);
+            v = _mm_loadu_si128((const __m128i*) tail);
+        }
+
+        if ( _mm_movemask_epi8(v) == 0 ) {
+            err = _mm_or_si128(err, inc);
+            inc = _mm_setzero_si128();
+        } else {
+            err = _mm_or_si128(err, Utf8ErrorsSSE(v, prev));
+            inc = _mm_subs_epu8(v, maxt);
+        }
+        prev = v;
+    }
+
+    err = _mm_or_si128(err, inc);
+
+    if ( _mm_testz_si128(err, err) )
+        return end;
+
+    return ValidUtf8Scalar(beg, end);
+}
+
+// ------------------------------------------------------------------------- //
+//  avx2
+
+TCAJSON_TARGET("avx2") static inline uint64_t
+MatchAVX2 ( const __m256i v[2], char c )
+{
+    const __m256i  cv = _mm256_set1_epi8(c);
+    uint64_t lo = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v[0], cv));
+    uint64_t hi = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v[1], cv));
+
+    return lo | (hi << 32);
+}
+
+TCAJSON_TARGET("avx2") static void
+ClassifyAVX2 ( const char * p, JsonBlockMasks & m )
+{
+    __m256i v[2];
+
+    v[0] = _mm256_loadu_si256((const __m256i*) p);
+    v[1] = _mm256_loadu_si256((const __m256i*)(p + 32));
+
+    m.quote     = MatchAVX2(v, TOKEN_STRING_SEPARATOR);
+    m.backslash = MatchAVX2(v, '\\');
+    m.space     = MatchAVX2(v, TOKEN_WS)  | MatchAVX2(v, '\t')
+                | MatchAVX2(v, '\n')      | MatchAVX2(v, '\r');
+    m.op        = MatchAVX2(v, TOKEN_ARRAY_BEGIN)    | MatchAVX2(v, TOKEN_ARRAY_END)
+                | MatchAVX2(v, TOKEN_OBJECT_BEGIN)   | MatchAVX2(v, TOKEN_OBJECT_END)
+                | MatchAVX2(v, TOKEN_NAME_SEPARATOR) | MatchAVX2(v, TOKEN_VALUE_SEPARATOR);
+}
+
+TCAJSON_TARGET("avx2") static const char*
+SkipSpaceAVX2 ( const char * p, const char * end )
+{
+    const __m256i sp = _mm256_set1_epi8(TOKEN_WS);
+    const __m256i tb = _mm256_set1_epi8('\t');
+    const __m256i nl = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+
+    while ( end - p >= 32 ) {
+        __m256i  v  = _mm256_loadu_si256((const __m256i*) p);
+        __m256i  ws = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tb)),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(v, nl), _mm256_cmpeq_epi8(v, cr)));
+        uint32_t m  = ~(uint32_t) _mm256_movemask_epi8(ws);
+
+        if ( m )
+            return p + __builtin_ctz(m);
+        p += 32;
+    }
+
+    return SkipSpaceSSE(p, end);
+}
+
+TCAJSON_TARGET("avx2") static const char*
+ScanStringAVX2 ( const char * p, const char * end )
+{
+    const __m256i qt = _mm256_set1_epi8(TOKEN_STRING_SEPARATOR);
+    const __m256i bs = _mm256_set1_epi8('\\');
+    const __m256i cc = _mm256_set1_epi8(0x1F);
+
+    while ( end - p >= 32 ) {
+        __m256i  v = _mm256_loadu_si256((const __m256i*) p);
+        __m256i  r = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(v, qt), _mm256_cmpeq_epi8(v, bs)),
+                        _mm256_cmpeq_epi8(_mm256_max_epu8(v, cc), cc));
+        uint32_t m = (uint32_t) _mm256_movemask_epi8(r);
+
+        if ( m )
+            return p + __builtin_ctz(m);
+        p += 32;
+    }
+
+    return ScanStringSSE(p, end);
+}
+
+/* Returns the error bits of the 32 bytes 'v' following 'prev' */
+TCAJSON_TARGET("avx2") static inline __m256i
+Utf8ErrorsAVX2 ( __m256i v, __m256i prev )
+{
+    const __m256i nib = _mm256_set1_epi8(0x0F);
+    const __m256i t1  = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*) Utf8Byte1High));
+    const __m256i t2  = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*) Utf8Byte1Low));
+    const __m256i t3  = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*) Utf8Byte2High));
+
+    __m256i  shft  = _mm256_permute2x128_si256(prev, v, 0x21);
+    __m256i  prev1 = _mm256_alignr_epi8(v, shft, 15);
+    __m256i  prev2 = _mm256_alignr_epi8(v, shft, 14);
+    __m256i  prev3 = _mm256_alignr_epi8(v, shft, 13);
+
+    __m256i  b1h = _mm256_shuffle_epi8(t1, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nib));
+    __m256i  b1l = _mm256_shuffle_epi8(t2, _mm256_and_si256(prev1, nib));
+    __m256i  b2h = _mm256_shuffle_epi8(t3, _mm256_and_si256(_mm256_srli_epi16(v, 4), nib));
+    __m256i  sc  = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+
+    __m256i  m23 = _mm256_or_si256(
+                    _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+                    _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+
+    return _mm256_xor_si256(sc, _mm256_and_si256(m23, _mm256_set1_epi8((char) 0x80)));
+}
+
+TCAJSON_TARGET("avx2") static const char*
+ValidUtf8AVX2 ( const char * p, const char * end )
+{
+    const char *  beg  = p;
+    const __m256i maxt = _mm256_loadu_si256((const __m256i*) Utf8MaxTail);
+
+    __m256i  prev = _mm256_setzero_si256();
+    __m256i  err  = _mm256_setzero_si256();
+    __m256i  inc  = _mm256_setzero_si256();
+    char     tail[32];
+
+    if ( end - p < 32 )
+        return ValidUtf8SSE(p, end);
+
+    for ( ; p < end; p += 32 )
+    {
+        __m256i  v;
+
+        if ( end - p >= 32 ) {
+            v = _mm256_loadu_si256((const __m256i*) p);
+        } else {
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, p, end - p);
+            v = _mm256_loadu_si256((const __m256i*) tail);
+        }
+
+        if ( _mm256_movemask_epi8(v) == 0 ) {
+            err = _mm256_or_si256(err, inc);
+            inc = _mm256_setzero_si256();
+        } else {
+            err = _mm256_or_si256(err, Utf8ErrorsAVX2(v, prev));
+            inc = _mm256_subs_epu8(v, maxt);
+        }
+        prev = v;
+    }
+
+    err = _mm256_or_si256(err, inc);
+
+    if ( _mm256_testz_si256(err, err) )
+        return end;
+
+    return ValidUtf8Scalar(beg, end);
+}
+
+// ------------------------------------------------------------------------- //
+//  avx512
+
+TCAJSON_TARGET("avx512f,avx512bw") static inline uint64_t
+MatchAVX512 ( __m512i v, char c )
+{
+    return _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(c));
+}
+
+TCAJSON_TARGET("avx512f,avx512bw") static void
+ClassifyAVX512 ( const char * p, JsonBlockMasks & m )
+{
+    __m512i  v = _mm512_loadu_si512((const void*) p);
+
+    m.quote     = MatchAVX512(v, TOKEN_STRING_SEPARATOR);
+    m.backslash = MatchAVX512(v, '\\');
+    m.space     = MatchAVX512(v, TOKEN_WS)  | MatchAVX512(v, '\t')
+                | MatchAVX512(v, '\n')      | MatchAVX512(v, '\r');
+    m.op        = MatchAVX512(v, TOKEN_ARRAY_BEGIN)    | MatchAVX512(v, TOKEN_ARRAY_END)
+                | MatchAVX512(v, TOKEN_OBJECT_BEGIN)   | MatchAVX512(v, TOKEN_OBJECT_END)
+                | MatchAVX512(v, TOKEN_NAME_SEPARATOR) | MatchAVX512(v, TOKEN_VALUE_SEPARATOR);
+}
+
+TCAJSON_TARGET("avx512f,avx512bw") static const char*
+SkipSpaceAVX512 ( const char * p, const char * end )
+{
+    while ( end - p >= 64 ) {
+        __m512i   v = _mm512_loadu_si512((const void*) p);
+        uint64_t  m = ~(MatchAVX512(v, TOKEN_WS) | MatchAVX512(v, '\t')
+                      | MatchAVX512(v, '\n')     | MatchAVX512(v, '\r'));
+
+        if ( m )
+            return p + __builtin_ctzll(m);
+        p += 64;
+    }
+
+    return SkipSpaceAVX2(p, end);
+}
+
+TCAJSON_TARGET("avx512f,avx512bw") static const char*
+ScanStringAVX512 ( const char * p, const char * end )
+{
+    const __m512i cc = _mm512_set1_epi8(0x1F);
+
+    while ( end - p >= 64 ) {
+        __m512i   v = _mm512_loadu_si512((const void*) p);
+        uint64_t  m = MatchAVX512(v, TOKEN_STRING_SEPARATOR) | MatchAVX512(v, '\\')
+                    | _mm512_cmple_epu8_mask(v, cc);
+
+        if ( m )
+            return p + __builtin_ctzll(m);
+        p += 64;
+    }
+
+    return ScanStringAVX2(p, end);
+}
+
+#endif  // TCAJSON_X86
+
+// ------------------------------------------------------------------------- //
+
+static const JsonKernels  KernelsScalar = {
+    "scalar", ClassifyScalar, SkipSpaceScalar, ScanStringScalar, ValidUtf8Scalar
+};
+
+#if defined(TCAJSON_X86)
+static const JsonKernels  KernelsSSE = {
+    "sse4.2", ClassifySSE, SkipSpaceSSE, ScanStringSSE, ValidUtf8SSE
+};
+
+static const JsonKernels  KernelsAVX2 = {
+    "avx2", ClassifyAVX2, SkipSpaceAVX2, ScanStringAVX2, ValidUtf8AVX2
+};
+
+// utf-8 validation shares the avx2 kernel
+static const JsonKernels  KernelsAVX512 = {
+    "avx512", ClassifyAVX512, SkipSpaceAVX512, ScanStringAVX512, ValidUtf8AVX2
+};
+#endif
+
+
+static std::atomic<const JsonKernels*>  ActiveKernels(nullptr);
+
+
+/* Returns the kernel tables supported by the running CPU, best first */
+static std::vector<const JsonKernels*>
+SupportedKernels()
+{
+    std::vector<const JsonKernels*>  kernels;
+
+#if defined(TCAJSON_X86)
+    __builtin_cpu_init();
+
+    if ( __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") )
+        kernels.push_back(&KernelsAVX512);
+    if ( __builtin_cpu_supports("avx2") )
+        kernels.push_back(&KernelsAVX2);
+    if ( __builtin_cpu_supports("sse4.2") )
+        kernels.push_back(&KernelsSSE);
+#endif
+
+    kernels.push_back(&KernelsScalar);
+
+    return kernels;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Returns the active kernel table, detecting the best implementation
+  * for the running CPU on first use.
+ **/
+const JsonKernels&
+JsonKernels::Active()
+{
+    const JsonKernels * k = ActiveKernels.load(std::memory_order_acquire);
+
+    if ( k == nullptr ) {
+        k = SupportedKernels().front();
+        ActiveKernels.store(k, std::memory_order_release);
+    }
+
+    return *k;
+}
+
+
+/** Forces the kernel implementation of the given name. Returns false
+  * if the implementation is unknown or not supported by this CPU.
+  * The name "auto" restores the detected default.
+ **/
+bool
+JsonKernels::Select ( const std::string & name )
+{
+    std::vector<const JsonKernels*>  kernels = SupportedKernels();
+
+    if ( name.compare("auto") == 0 ) {
+        ActiveKernels.store(kernels.front(), std::memory_order_release);
+        return true;
+    }
+
+    for ( const JsonKernels * k : kernels ) {
+        if ( name.compare(k->name) == 0 ) {
+            ActiveKernels.store(k, std::memory_order_release);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/** Returns the names of all implementations supported by this CPU */
+std::vector<std::string>
+JsonKernels::Available()
+{
+    std::vector<std::string>  names;
+
+    for ( const JsonKernels * k : SupportedKernels() )
+        names.push_back(k->name);
+
+    return names;
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONKERNELS_CPP_
@@ -0,0 +1,305 @@
+/**
+  * @file JsonLines.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONLINES_CPP_
+
+#include <algorithm>
+#include <cstring>
+
+#include "JsonLines.h"
+
+
+namespace tcajson {
+
+
+// ------------------------------------------------------------------------- //
+
+JsonLines::JsonLines()
+    : _strm(nullptr),
+      _off(0),
+      _valid(false),
+      _lineno(0),
+      _records(0),
+      _errors(0),
+      _bytes(0),
+      _elapsed(clock_type::duration::zero())
+{}
+
+
+/** Constructs a reader of the records in the provided buffer. The
+  * buffer is not copied and must outlive the reader.
+ **/
+JsonLines::JsonLines ( std::string_view buf )
+    : JsonLines()
+{
+    this->assign(buf);
+}
+
+
+/** Constructs a reader of the records of the provided input stream */
+JsonLines::JsonLines ( std::istream & strm )
+    : JsonLines()
+{
+    this->assign(strm);
+}
+
+
+JsonLines::~JsonLines()
+{
+    this->close();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Opens the given file for reading. A regular file is memory mapped
+  * and its lines parsed in place, while other files, such as pipes, are
+  * read as a stream. Returns false if the file could not be opened.
+ **/
+bool
+JsonLines::open ( const std::string & filename )
+{
+    this->close();
+
+    if ( _map.open(filename) ) {
+        this->assign(_map.view());
+        return true;
+    }
+
+    _file.open(filename, std::ios::in | std::ios::binary);
+
+    if ( ! _file.is_open() )
+        return false;
+
+    this->assign(_file);
+
+    return true;
+}
+
+
+/** Reads records from the provided buffer, which is not copied */
+void
+JsonLines::assign ( std::string_view buf )
+{
+    _strm   = nullptr;
+    _data   = buf;
+    _off    = 0;
+    _line   = std::string_view();
+    _valid  = false;
+    _lineno = 0;
+}
+
+
+/** Reads records from the provided input stream */
+void
+JsonLines::assign ( std::istream & strm )
+{
+    _strm   = &strm;
+    _data   = std::string_view();
+    _off    = 0;
+    _line   = std::string_view();
+    _valid  = false;
+    _lineno = 0;
+}
+
+
+/** Closes any open file and releases the current input. The record
+  * statistics are retained until resetStats().
+ **/
+void
+JsonLines::close()
+{
+    if ( _file.is_open() )
+        _file.close();
+
+    _map.close();
+    _file.clear();
+    _buf.clear();
+    this->assign(std::string_view());
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Advances to the next record, returning false at the end of the
+  * input. The record is parsed into the reused JSON document. If the
+  * line is not a valid JSON document, valid() returns false and the
+  * error is available via getErrorPos() and getErrorStr().
+ **/
+bool
+JsonLines::next()
+{
+    clock_type::time_point  t0 = clock_type::now();
+    bool  res = false;
+
+    while ( this->nextLine() )
+    {
+        ++_lineno;
+
+        if ( ! _line.empty() && _line.back() == '\r' )
+            _line.remove_suffix(1);
+
+        if ( _line.find_first_not_of(" \t\r") == std::string_view::npos )
+            continue;
+
+        _valid = _json.parse(_line);
+
+        ++_records;
+        if ( ! _valid )
+            ++_errors;
+
+        res = true;
+        break;
+    }
+
+    if ( ! res ) {
+        _line  = std::string_view();
+        _valid = false;
+    }
+
+    _elapsed += clock_type::now() - t0;
+
+    return res;
+}
+
+
+/** Enables UTF-8 validation of the records, see JSON::setValidateUtf8 */
+void
+JsonLines::setValidateUtf8 ( bool validate )
+{
+    _json.setValidateUtf8(validate);
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Locates the next line of input, without its newline, refilling the
+  * stream buffer as needed. The final line need not end in a newline.
+ **/
+bool
+JsonLines::nextLine()
+{
+    while ( true )
+    {
+        const char * p   = _data.data() + _off;
+        size_t       rem = _data.size() - _off;
+        const char * nl  = nullptr;
+
+        if ( rem > 0 )
+            nl = (const char*) std::memchr(p, '\n', rem);
+
+        if ( nl != nullptr ) {
+            _line   = std::string_view(p, nl - p);
+            _off   += _line.size() + 1;
+            _bytes += _line.size() + 1;
+            return true;
+        }
+
+        if ( _strm == nullptr || ! this->fill() )
+        {
+            rem = _data.size() - _off;
+
+            if ( rem == 0 )
+                return false;
+
+            _line   = _data.substr(_off);
+            _off    = _data.size();
+            _bytes += rem;
+            return true;
+        }
+    }
+}
+
+
+/** Reads the next block of the input stream, keeping any partial
+  * line at the front of the buffer. Returns false at end of stream.
+ **/
+bool
+JsonLines::fill()
+{
+    size_t  keep = _data.size() - _off;
+    size_t  want = std::max((size_t) TCAJSON_LINES_BUFSZ, keep);
+    size_t  got  = 0;
+
+    _buf.erase(0, _buf.size() - keep);
+    _buf.resize(keep + want);
+
+    if ( _strm->good() ) {
+        _strm->read(&_buf[keep], want);
+        got = _strm->gcount();
+    }
+
+    _buf.resize(keep + got);
+    _data = _buf;
+    _off  = 0;
+
+    return (got > 0);
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Returns the time in seconds spent reading and parsing records */
+double
+JsonLines::getElapsed() const
+{
+    return std::chrono::duration<double>(_elapsed).count();
+}
+
+
+/** Returns the number of records, valid or not, read per second */
+double
+JsonLines::getRecordsPerSec() const
+{
+    double secs = this->getElapsed();
+
+    if ( secs == 0.0 )
+        return 0.0;
+
+    return (double) _records / secs;
+}
+
+
+/** Returns the number of bytes of input consumed per second */
+double
+JsonLines::getBytesPerSec() const
+{
+    double secs = this->getElapsed();
+
+    if ( secs == 0.0 )
+        return 0.0;
+
+    return (double) _bytes / secs;
+}
+
+
+void
+JsonLines::resetStats()
+{
+    _records = 0;
+    _errors  = 0;
+    _bytes   = 0;
+    _elapsed = clock_type::duration::zero();
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONLINES_CPP_
@@ -0,0 +1,137 @@
+/**
+  * @file JsonMappedFile.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONMAPPEDFILE_CPP_
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "JsonMappedFile.h"
+
+
+namespace tcajson {
+
+
+JsonMappedFile::JsonMappedFile()
+    : _addr(nullptr),
+      _size(0),
+      _open(false)
+{}
+
+
+/** Maps the given file, throwing a runtime_error if it could not be
+  * mapped.
+ **/
+JsonMappedFile::JsonMappedFile ( const std::string & filename )
+    : JsonMappedFile()
+{
+    if ( ! this->open(filename) )
+        throw ( std::runtime_error(_errstr) );
+}
+
+
+JsonMappedFile::~JsonMappedFile()
+{
+    this->close();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Maps the given file read-only, replacing any current mapping.
+  * Returns false if the file could not be opened or mapped, such as a
+  * pipe or other file that is not seekable, with the reason available
+  * via getErrorStr().
+ **/
+bool
+JsonMappedFile::open ( const std::string & filename )
+{
+    struct stat  sb;
+    void *       addr = nullptr;
+    int          fd;
+
+    this->close();
+
+    if ( (fd = ::open(filename.c_str(), O_RDONLY)) < 0 ) {
+        _errstr = "Error opening file " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    if ( ::fstat(fd, &sb) < 0 ) {
+        _errstr = "Error reading file " + filename + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    if ( ! S_ISREG(sb.st_mode) ) {
+        _errstr = "Error mapping file " + filename + ": not a regular file";
+        ::close(fd);
+        return false;
+    }
+
+    if ( sb.st_size > 0 ) {
+        addr = ::mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if ( addr == MAP_FAILED ) {
+            _errstr = "Error mapping file " + filename + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+
+        ::madvise(addr, sb.st_size, MADV_SEQUENTIAL);
+        ::madvise(addr, sb.st_size, MADV_WILLNEED);
+    }
+
+    ::close(fd);
+
+    _addr = (const char*) addr;
+    _size = sb.st_size;
+    _open = true;
+    _errstr.clear();
+
+    return true;
+}
+
+
+/** Releases the mapping, invalidating any views of it */
+void
+JsonMappedFile::close()
+{
+    if ( _addr != nullptr )
+        ::munmap((void*) _addr, _size);
+
+    _addr = nullptr;
+    _size = 0;
+    _open = false;
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONMAPPEDFILE_CPP_
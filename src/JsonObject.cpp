@@ -24,8 +24,10 @@
 #define _TCAJSON_JSONOBJECT_CPP_
 
 #include "JsonObject.h"
+#include "JsonArena.h"
 #include "JSON.h"
 
+#include <functional>
 #include <stdexcept>
 
 
@@ -39,6 +41,15 @@ JsonObject::JsonObject()
     : JsonType(JSON_OBJECT)
 {}
 
+/** Constructs an empty JsonObject whose members are allocated with
+  * the given allocator.
+ **/
+JsonObject::JsonObject ( const allocator_type & alloc )
+    : JsonType(JSON_OBJECT),
+      _items(alloc),
+      _index(alloc)
+{}
+
 /**  JsonObject copy constructor */
 JsonObject::JsonObject ( const JsonObject & obj )
     : JsonType(JSON_OBJECT)
@@ -46,6 +57,43 @@ JsonObject::JsonObject ( const JsonObject & obj )
     *this = obj;
 }
 
+/**  JsonObject copy constructor using the given allocator */
+JsonObject::JsonObject ( const JsonObject & obj, const allocator_type & alloc )
+    : JsonType(JSON_OBJECT),
+      _items(alloc),
+      _index(alloc)
+{
+    *this = obj;
+}
+
+/** JsonObject move constructor, taking the members of 'obj' along
+  * with its allocator.
+ **/
+JsonObject::JsonObject ( JsonObject && obj ) noexcept
+    : JsonType(JSON_OBJECT),
+      _items(std::move(obj._items)),
+      _index(std::move(obj._index))
+{}
+
+/** JsonObject move constructor using the given allocator. The members
+  * are taken without copying when the allocators are equal, otherwise
+  * they are copied with the given allocator, as the source may release
+  * its memory, and the values of 'obj' are deleted.
+ **/
+JsonObject::JsonObject ( JsonObject && obj, const allocator_type & alloc )
+    : JsonType(JSON_OBJECT),
+      _items(alloc),
+      _index(alloc)
+{
+    JsonArena * arena = dynamic_cast<JsonArena*>(alloc.resource());
+    bool        same  = (alloc == obj.get_allocator());
+
+    this->moveItems(obj);
+
+    if ( same && arena != nullptr && ! obj.inArena() && ! _items.empty() )
+        arena->adopt();
+}
+
 /** JsonObject destructor */
 JsonObject::~JsonObject()
 {
@@ -54,80 +102,134 @@ JsonObject::~JsonObject()
 
 // ------------------------------------------------------------------------- //
 
-/** JsonObject assignment operator */
+/** JsonObject assignment operator. The values of 'obj' are copied
+  * with the allocator of this object before the current values are
+  * deleted, so an object may be assigned one of its own members.
+ **/
 JsonObject&
 JsonObject::operator= ( const JsonObject & obj )
 {
     if ( this == &obj )
         return *this;
 
-    this->_items.clear();
-    this->_type  = obj._type;
+    JsonItems  items(_items.get_allocator());
+
+    items.reserve(obj.size());
 
     JsonObject::const_iterator jIter;
     for ( jIter = obj.begin(); jIter != obj.end(); ++jIter )
-    {
-        json_t  t = jIter->second->getType();
-
-        switch ( t ) {
-            case JSON_OBJECT:
-                this->insert(jIter->first, new JsonObject(*((JsonObject*)jIter->second)));
-                break;
-            case JSON_ARRAY:
-                this->insert(jIter->first, new JsonArray(*((JsonArray*)jIter->second)));
-                break;
-            case JSON_NUMBER:
-                this->insert(jIter->first, new JsonNumber(*((JsonNumber*)jIter->second)));
-                break;
-            case JSON_STRING:
-                this->insert(jIter->first, new JsonString(*((JsonString*)jIter->second)));
-                break;
-            case JSON_BOOLEAN:
-                this->insert(jIter->first, new JsonBoolean(*((JsonBoolean*)jIter->second)));
-                break;
-            case JSON_NULL:
-                this->insert(jIter->first, new JsonType(JSON_NULL));
-                break;
-            default:
-                break;
-        }
-    }
+        items.emplace_back(jIter->first, JSON::Copy(jIter->second, _items.get_allocator()));
+
+    this->_type  = obj._type;
+    this->clear();
+    this->_items.swap(items);
+    this->buildIndex();
 
     return *this;
 }
 
+/** JsonObject move assignment. The members of 'obj' are taken before
+  * the current values are deleted, so an object may be assigned one of
+  * its own members, and 'obj' is left empty.
+ **/
+JsonObject&
+JsonObject::operator= ( JsonObject && obj )
+{
+    if ( this == &obj )
+        return *this;
+
+    JsonObject  moved(std::move(obj), _items.get_allocator());
+
+    this->clear();
+    this->_items.swap(moved._items);
+    this->_index.swap(moved._index);
+
+    return *this;
+}
+
+/** Takes the members of 'obj' into this empty object, swapping the
+  * storage when the allocators are equal, and otherwise copying each
+  * member with the allocator of this object and emptying 'obj'.
+ **/
+void
+JsonObject::moveItems ( JsonObject & obj )
+{
+    if ( _items.get_allocator() == obj._items.get_allocator() ) {
+        _items.swap(obj._items);
+        _index.swap(obj._index);
+        return;
+    }
+
+    _items.reserve(obj.size());
+
+    JsonObject::iterator jIter;
+    for ( jIter = obj.begin(); jIter != obj.end(); ++jIter ) {
+        JsonType * item = nullptr;
+        if ( jIter->second )
+            item = JSON::Copy(jIter->second, _items.get_allocator());
+        _items.emplace_back(jIter->first, item);
+    }
+
+    obj.clear();
+    this->buildIndex();
+}
+
 // ------------------------------------------------------------------------- //
 
 JsonType*
-JsonObject::operator[] ( const std::string & key )
+JsonObject::operator[] ( std::string_view key )
 {
-    iterator iter;
+    size_t  pos = this->indexOf(key);
 
-    if ( (iter = this->find(key)) == _items.end() )
+    if ( pos == _items.size() )
         return nullptr;
-    return iter->second;
+    return _items[pos].second;
 }
 
 const JsonType*
-JsonObject::operator[] ( const std::string & key ) const
+JsonObject::operator[] ( std::string_view key ) const
 {
-    const_iterator iter = this->find(key);
-    if ( iter == _items.end() )
+    size_t  pos = this->indexOf(key);
+
+    if ( pos == _items.size() )
         return nullptr;
-    return iter->second;
+    return _items[pos].second;
 }
 
 // ------------------------------------------------------------------------- //
 
+/** Inserts the item with the given key, taking ownership of the
+  * item. Throws a runtime_error if the key already exists.
+ **/
 JsonObject::pairI
-JsonObject::insert ( const std::string & key, JsonType * item )
+JsonObject::insert ( std::string_view key, JsonType * item )
 {
-    JsonObject::iterator iter;
+    if ( this->indexOf(key) != _items.size() )
+        throw ( std::runtime_error("JsonObject::insert() Item already exists: "
+                    + std::string(key)) );
+
+    _items.emplace_back(key, item);
 
-    if ( (iter = this->find(key)) != _items.end() )
-        throw ( std::runtime_error("JsonObject::insert() Item already exists: " + key ) );
+    if ( _items.size() > TCAJSON_OBJECT_INDEXSZ )
+        this->indexAdd(_items.size() - 1);
 
-    return _items.insert(JsonItems::value_type(key, item));
+    if ( _arena && item != nullptr && ! item->inArena() )
+        ((JsonArena*) _items.get_allocator().resource())->adopt();
+
+    return JsonObject::pairI(std::prev(_items.end()), true);
+}
+
+/** Inserts the item with the given key, taking ownership of the item
+  * only once inserted, so that it is freed if the key already exists.
+ **/
+JsonObject::pairI
+JsonObject::insert ( std::string_view key, std::unique_ptr<JsonType> item )
+{
+    JsonObject::pairI  result = this->insert(key, item.get());
+
+    item.release();
+
+    return result;
 }
 
 // ------------------------------------------------------------------------- //
@@ -140,6 +242,9 @@ JsonObject::erase ( JsonObject::iterator at )
         return _items.end();
     if ( at->second )
         delete at->second;
+
+    this->indexRemove(at - _items.begin(), 1);
+
     return _items.erase(at);
 }
 
@@ -153,40 +258,182 @@ JsonObject::erase ( JsonObject::iterator first, JsonObject::iterator last )
             delete iter->second;
     }
 
+    this->indexRemove(first - _items.begin(), last - first);
+
     return _items.erase(first, last);
 }
 
 JsonObject::size_type
-JsonObject::erase ( const std::string & key )
+JsonObject::erase ( std::string_view key )
 {
-    return _items.erase(key);
+    iterator iter = this->find(key);
+
+    if ( iter == _items.end() )
+        return 0;
+
+    this->indexRemove(iter - _items.begin(), 1);
+    _items.erase(iter);
+
+    return 1;
 }
 
 // ------------------------------------------------------------------------- //
 
 /** Method for finding the associated value to the provided key */
 JsonObject::iterator
-JsonObject::find ( const std::string & key )
+JsonObject::find ( std::string_view key )
 {
-    return _items.find(key);
+    return _items.begin() + this->indexOf(key);
 }
 
 JsonObject::const_iterator
-JsonObject::find ( const std::string & key ) const
+JsonObject::find ( std::string_view key ) const
 {
-    return _items.find(key);
+    return _items.begin() + this->indexOf(key);
 }
 
 /** Returns a boolean indicating the existance of the given key */
 bool
-JsonObject::exists ( const std::string & key ) const
+JsonObject::exists ( std::string_view key ) const
+{
+    return this->indexOf(key) != _items.size();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Returns the position of the member with the given key, or size()
+  * if there is no such member. Objects larger than
+  * TCAJSON_OBJECT_INDEXSZ are searched through their hash index.
+ **/
+size_t
+JsonObject::indexOf ( std::string_view key ) const
+{
+    size_t  sz = _items.size();
+
+    if ( sz <= TCAJSON_OBJECT_INDEXSZ ) {
+        for ( size_t i = 0; i < sz; ++i ) {
+            if ( std::string_view(_items[i].first) == key )
+                return i;
+        }
+        return sz;
+    }
+
+    size_t  mask = _index.size() - 1;
+    size_t  slot = std::hash<std::string_view>()(key) & mask;
+
+    while ( _index[slot] != 0 ) {
+        size_t  i = _index[slot] - 1;
+        if ( std::string_view(_items[i].first) == key )
+            return i;
+        slot = (slot + 1) & mask;
+    }
+
+    return sz;
+}
+
+
+/** Builds the open addressing hash index of the keys, sized to a power
+  * of two of at least twice the number of members, or drops it while
+  * the object is small enough to search linearly. Each slot holds the
+  * position of a member plus one, with zero marking an empty slot.
+ **/
+void
+JsonObject::buildIndex()
 {
-    JsonObject::const_iterator iter;
+    size_t  slots = 16;
+
+    if ( _items.size() <= TCAJSON_OBJECT_INDEXSZ ) {
+        _index.clear();
+        return;
+    }
+
+    while ( slots < _items.size() * 2 )
+        slots <<= 1;
+
+    _index.assign(slots, 0);
+
+    for ( size_t i = 0; i < _items.size(); ++i )
+        this->indexAdd(i);
+}
 
-    if ( (iter = this->find(key)) != this->end() )
-        return true;
 
-    return false;
+/** Adds the member at 'pos' to the hash index, building the index
+  * anew when it is empty or more than half full.
+ **/
+void
+JsonObject::indexAdd ( uint32_t pos )
+{
+    if ( (size_t) pos * 2 >= _index.size() ) {
+        this->buildIndex();
+        return;
+    }
+
+    size_t  mask = _index.size() - 1;
+    size_t  slot = std::hash<std::string_view>()(_items[pos].first) & mask;
+
+    while ( _index[slot] != 0 )
+        slot = (slot + 1) & mask;
+
+    _index[slot] = pos + 1;
+}
+
+
+/** Removes the 'count' members from 'pos' from the hash index, before
+  * they are erased, and moves the positions of the members after them
+  * down by 'count', so that no key is hashed again. Each slot freed is
+  * refilled from the slots probed after it, keeping every key reachable
+  * from its home slot. The index is dropped once the object becomes
+  * small enough to search linearly.
+ **/
+void
+JsonObject::indexRemove ( size_t pos, size_t count )
+{
+    if ( _index.empty() || count == 0 )
+        return;
+
+    if ( _items.size() - count <= TCAJSON_OBJECT_INDEXSZ ) {
+        _index.clear();
+        return;
+    }
+
+    std::hash<std::string_view>  hash;
+    size_t                       mask = _index.size() - 1;
+
+    for ( size_t i = pos; i < pos + count; ++i )
+    {
+        size_t  hole = hash(_items[i].first) & mask;
+
+        while ( _index[hole] != i + 1 )
+            hole = (hole + 1) & mask;
+
+        size_t  next = (hole + 1) & mask;
+
+        while ( _index[next] != 0 ) {
+            size_t  home = hash(_items[_index[next] - 1].first) & mask;
+
+            if ( ((next - home) & mask) >= ((next - hole) & mask) ) {
+                _index[hole] = _index[next];
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+
+        _index[hole] = 0;
+    }
+
+    if ( pos + count == _items.size() )
+        return;
+
+    // the index holds a power of two of at least 16 slots, walked in
+    // blocks of 16 so that the loop is vectorized
+    uint32_t * slots = _index.data();
+    uint32_t   above = pos + count;
+    uint32_t   by    = count;
+
+    for ( size_t i = 0; i < _index.size(); i += 16 ) {
+        for ( size_t j = 0; j < 16; ++j )
+            slots[i + j] -= (slots[i + j] > above) ? by : 0;
+    }
 }
 
 // ------------------------------------------------------------------------- //
@@ -201,6 +448,7 @@ JsonObject::clear()
         if ( jIter->second )
             delete jIter->second;
     }
+    _index.clear();
     return _items.clear();
 }
 
@@ -218,10 +466,10 @@ JsonObject::toString ( bool asJson ) const
 
     for ( jIter = this->begin(); jIter != this->end(); ++jIter, ++i )
     {
-        const std::string & key  = jIter->first;
+        std::string_view    key  = jIter->first;
         const JsonType    * item = jIter->second;
 
-        jstr << TOKEN_STRING_SEPARATOR << key << TOKEN_STRING_SEPARATOR
+        jstr << TOKEN_STRING_SEPARATOR << JsonEscape(key) << TOKEN_STRING_SEPARATOR
              << TOKEN_WS << TOKEN_NAME_SEPARATOR << TOKEN_WS
              << JSON::ToString(item);
         if ( i < this->size() )
@@ -0,0 +1,406 @@
+/**
+  * @file JsonPipeline.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONPIPELINE_CPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "JsonPipeline.h"
+#include "JsonMappedFile.h"
+
+
+namespace tcajson {
+
+
+/* A chunk of the input, ending at a newline */
+struct JsonChunk {
+    size_t  beg;
+    size_t  end;
+    size_t  lines;
+    bool    done;
+};
+
+
+/* The parsed records of a chunk in ordered mode. Slots are reused
+ * round robin by the chunks of the window, along with their documents.
+ */
+struct JsonChunkSlot {
+    std::vector<std::unique_ptr<JSON>>  docs;
+    std::vector<JsonRecord>             recs;
+};
+
+
+/* The queue of chunks owned by one worker */
+struct JsonChunkQueue {
+    std::mutex          lock;
+    std::deque<size_t>  chunks;
+};
+
+
+/* The state shared by the workers of a single run */
+struct JsonPipelineState {
+    std::string_view                              buf;
+    JsonPipeline::Consumer &                      consumer;
+    bool                                          ordered;
+    bool                                          utf8;
+    size_t                                        window;
+    std::vector<JsonChunk>                        chunks;
+    std::vector<JsonChunkSlot>                    slots;
+    std::vector<std::unique_ptr<JsonChunkQueue>>  queues;
+    std::mutex                                    lock;
+    std::condition_variable                       cv;
+    size_t                                        delivered;
+    std::atomic<size_t>                           records;
+    std::atomic<size_t>                           errors;
+
+    JsonPipelineState ( std::string_view b, JsonPipeline::Consumer & c )
+        : buf(b), consumer(c), ordered(true), utf8(false), window(0),
+          delivered(0), records(0), errors(0)
+    {}
+};
+
+// ------------------------------------------------------------------------- //
+
+/* Takes the next chunk for the given worker, from the front of its own
+ * queue or else stolen from another queue. Thieves take the newest
+ * chunk, or in ordered mode the oldest, which is the next to be
+ * delivered.
+ */
+static bool
+NextChunk ( JsonPipelineState & st, size_t id, size_t & k )
+{
+    size_t  n = st.queues.size();
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+        JsonChunkQueue & q = *st.queues[(id + i) % n];
+        std::lock_guard<std::mutex>  guard(q.lock);
+
+        if ( q.chunks.empty() )
+            continue;
+
+        if ( i == 0 || st.ordered ) {
+            k = q.chunks.front();
+            q.chunks.pop_front();
+        } else {
+            k = q.chunks.back();
+            q.chunks.pop_back();
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/* Parses the lines of chunk 'k'. Records are handed to the consumer
+ * directly in unordered mode, or stored in the chunk slot for delivery.
+ */
+static void
+ParseChunk ( JsonPipelineState & st, size_t k, JSON & doc,
+             size_t & records, size_t & errors )
+{
+    JsonChunk &     chunk = st.chunks[k];
+    JsonChunkSlot * slot  = nullptr;
+    const char *    beg   = st.buf.data();
+    const char *    p     = beg + chunk.beg;
+    const char *    end   = beg + chunk.end;
+    size_t          line  = 0;
+    size_t          n     = 0;
+
+    if ( st.ordered ) {
+        slot = &st.slots[k % st.window];
+        slot->recs.clear();
+    }
+
+    while ( p < end )
+    {
+        const char * nl = (const char*) std::memchr(p, '\n', end - p);
+        const char * e  = (nl != nullptr) ? nl : end;
+
+        std::string_view  ln(p, e - p);
+        JsonRecord        rec;
+
+        ++line;
+
+        if ( ! ln.empty() && ln.back() == '\r' )
+            ln.remove_suffix(1);
+
+        if ( ln.find_first_not_of(" \t\r") != std::string_view::npos )
+        {
+            rec.doc = &doc;
+
+            if ( slot != nullptr ) {
+                if ( n == slot->docs.size() ) {
+                    slot->docs.emplace_back(new JSON());
+                    slot->docs.back()->setValidateUtf8(st.utf8);
+                }
+                rec.doc = slot->docs[n++].get();
+            }
+
+            rec.line   = ln;
+            rec.offset = p - beg;
+            rec.lineno = 0;
+            rec.valid  = rec.doc->parse(ln);
+
+            ++records;
+            if ( ! rec.valid )
+                ++errors;
+
+            if ( slot != nullptr ) {
+                rec.lineno = line;
+                slot->recs.push_back(rec);
+            } else {
+                st.consumer(rec);
+            }
+        }
+
+        p = e + 1;
+    }
+
+    chunk.lines = line;
+}
+
+
+static void
+RunWorker ( JsonPipelineState & st, size_t id )
+{
+    JSON    doc;
+    size_t  k;
+    size_t  records = 0;
+    size_t  errors  = 0;
+
+    doc.setValidateUtf8(st.utf8);
+
+    while ( NextChunk(st, id, k) )
+    {
+        if ( st.ordered ) {
+            std::unique_lock<std::mutex>  guard(st.lock);
+            st.cv.wait(guard, [&] { return k < st.delivered + st.window; });
+        }
+
+        ParseChunk(st, k, doc, records, errors);
+
+        if ( st.ordered ) {
+            std::lock_guard<std::mutex>  guard(st.lock);
+            st.chunks[k].done = true;
+            st.cv.notify_all();
+        }
+    }
+
+    st.records += records;
+    st.errors  += errors;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Constructs a pipeline of the given number of worker threads, where
+  * 0 uses one thread per hardware thread.
+ **/
+JsonPipeline::JsonPipeline ( size_t threads, bool ordered )
+    : _threads(1),
+      _ordered(ordered),
+      _utf8(false),
+      _chunksz(TCAJSON_PIPELINE_CHUNKSZ),
+      _records(0),
+      _errors(0),
+      _bytes(0),
+      _elapsed(clock_type::duration::zero())
+{
+    this->setThreads(threads);
+}
+
+
+JsonPipeline::~JsonPipeline()
+{}
+
+// ------------------------------------------------------------------------- //
+
+void
+JsonPipeline::setThreads ( size_t threads )
+{
+    if ( threads == 0 )
+        threads = std::thread::hardware_concurrency();
+
+    _threads = (threads > 0) ? threads : 1;
+}
+
+
+void
+JsonPipeline::setChunkSize ( size_t sz )
+{
+    _chunksz = (sz > 0) ? sz : TCAJSON_PIPELINE_CHUNKSZ;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Parses the newline-delimited records of the given buffer, passing
+  * each to the consumer. Returns once all records are delivered.
+ **/
+bool
+JsonPipeline::run ( std::string_view buf, Consumer consumer )
+{
+    clock_type::time_point    t0 = clock_type::now();
+    JsonPipelineState         st(buf, consumer);
+    std::vector<std::thread>  workers;
+    size_t                    off = 0;
+
+    st.ordered = _ordered;
+    st.utf8    = _utf8;
+    st.window  = _threads * 4;
+
+    // split at the first newline following each chunk size
+    while ( off < buf.size() )
+    {
+        size_t  end = off + _chunksz;
+
+        if ( end >= buf.size() ) {
+            end = buf.size();
+        } else {
+            const char * nl = (const char*) std::memchr(buf.data() + end, '\n',
+                                                        buf.size() - end);
+            end = (nl != nullptr) ? (nl - buf.data()) + 1 : buf.size();
+        }
+
+        st.chunks.push_back(JsonChunk{ off, end, 0, false });
+        off = end;
+    }
+
+    // contiguous runs of chunks per worker, or interleaved when ordered
+    size_t  per = (st.chunks.size() + _threads - 1) / _threads;
+
+    for ( size_t i = 0; i < _threads; ++i )
+        st.queues.emplace_back(new JsonChunkQueue());
+
+    for ( size_t k = 0; k < st.chunks.size(); ++k ) {
+        size_t id = _ordered ? (k % _threads) : (k / per);
+        st.queues[id]->chunks.push_back(k);
+    }
+
+    if ( _ordered )
+        st.slots.resize(st.window);
+
+    for ( size_t i = 0; i < _threads; ++i )
+        workers.emplace_back(RunWorker, std::ref(st), i);
+
+    if ( _ordered )
+    {
+        size_t  base = 0;
+
+        for ( size_t k = 0; k < st.chunks.size(); ++k )
+        {
+            JsonChunkSlot & slot = st.slots[k % st.window];
+
+            {
+                std::unique_lock<std::mutex>  guard(st.lock);
+                st.cv.wait(guard, [&] { return st.chunks[k].done; });
+            }
+
+            for ( JsonRecord & rec : slot.recs ) {
+                rec.lineno += base;
+                consumer(rec);
+            }
+
+            base += st.chunks[k].lines;
+
+            std::lock_guard<std::mutex>  guard(st.lock);
+            st.delivered = k + 1;
+            st.cv.notify_all();
+        }
+    }
+
+    for ( std::thread & t : workers )
+        t.join();
+
+    _records = st.records;
+    _errors  = st.errors;
+    _bytes   = buf.size();
+    _elapsed = clock_type::now() - t0;
+
+    return true;
+}
+
+
+/** Parses the newline-delimited records of the given file, which is
+  * memory mapped rather than read. Returns false if the file could not
+  * be mapped, with the reason available via getErrorStr().
+ **/
+bool
+JsonPipeline::runFile ( const std::string & filename, Consumer consumer )
+{
+    JsonMappedFile  file;
+
+    if ( ! file.open(filename) ) {
+        _errstr = file.getErrorStr();
+        return false;
+    }
+
+    return this->run(file.view(), consumer);
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Returns the wall clock time in seconds of the last run */
+double
+JsonPipeline::getElapsed() const
+{
+    return std::chrono::duration<double>(_elapsed).count();
+}
+
+
+double
+JsonPipeline::getRecordsPerSec() const
+{
+    double secs = this->getElapsed();
+
+    if ( secs == 0.0 )
+        return 0.0;
+
+    return (double) _records / secs;
+}
+
+
+double
+JsonPipeline::getBytesPerSec() const
+{
+    double secs = this->getElapsed();
+
+    if ( secs == 0.0 )
+        return 0.0;
+
+    return (double) _bytes / secs;
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONPIPELINE_CPP_
@@ -0,0 +1,141 @@
+/**
+  * @file JsonProjection.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONPROJECTION_CPP_
+
+#include <stdexcept>
+
+#include "JsonProjection.h"
+
+
+namespace tcajson {
+
+
+JsonProjection::JsonProjection()
+    : _paths(0)
+{
+    this->clear();
+}
+
+
+/** Constructs a projection of the given paths. Throws a runtime_error
+  * if any path is malformed.
+ **/
+JsonProjection::JsonProjection ( const std::vector<std::string> & paths )
+    : _paths(0)
+{
+    this->clear();
+
+    for ( const std::string & path : paths ) {
+        if ( ! this->add(path) )
+            throw ( std::runtime_error("JsonProjection invalid path: " + path) );
+    }
+}
+
+
+JsonProjection::~JsonProjection()
+{}
+
+// ------------------------------------------------------------------------- //
+
+/** Adds a path to the projection. Returns false if the path is not a
+  * valid JSON Pointer.
+ **/
+bool
+JsonProjection::add ( std::string_view path )
+{
+    std::vector<std::string>  keys;
+    uint32_t                  node = 0;
+
+    if ( ! path.empty() && path.front() != '/' )
+        return false;
+
+    while ( ! path.empty() )
+    {
+        std::string  key;
+        size_t       end;
+
+        path.remove_prefix(1);
+
+        if ( (end = path.find('/')) == std::string_view::npos )
+            end = path.size();
+
+        for ( size_t i = 0; i < end; ++i )
+        {
+            if ( path[i] != '~' ) {
+                key.push_back(path[i]);
+                continue;
+            }
+
+            if ( ++i == end || (path[i] != '0' && path[i] != '1') )
+                return false;
+
+            key.push_back((path[i] == '0') ? '~' : '/');
+        }
+
+        keys.push_back(key);
+        path.remove_prefix(end);
+    }
+
+    for ( const std::string & key : keys )
+    {
+        uint32_t  child;
+
+        if ( _nodes[node].keep )
+            break;
+
+        if ( (child = this->find(node, key)) == npos ) {
+            child = _nodes.size();
+            _nodes[node].children.push_back(Child(key, child));
+            _nodes.push_back(Node{ false, {} });
+        }
+
+        node = child;
+    }
+
+    // a kept value has no need of its children
+    _nodes[node].keep = true;
+    _nodes[node].children.clear();
+
+    ++_paths;
+
+    return true;
+}
+
+
+/** Removes all paths. An empty projection keeps nothing but an empty
+  * root container.
+ **/
+void
+JsonProjection::clear()
+{
+    _nodes.clear();
+    _nodes.push_back(Node{ false, {} });
+    _paths = 0;
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONPROJECTION_CPP_
@@ -0,0 +1,478 @@
+/**
+  * @file JsonPushParser.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONPUSHPARSER_CPP_
+
+#include "JsonPushParser.h"
+
+
+namespace tcajson {
+
+
+static const uint8_t  JsonBom[3] = { 0xEF, 0xBB, 0xBF };
+
+// ------------------------------------------------------------------------- //
+
+JsonPushParser::JsonPushParser()
+    : _parser(_builder),
+      _state(PUSH_VALUE),
+      _tok(PTOK_NONE),
+      _escape(false),
+      _bom(0),
+      _buf(nullptr),
+      _tokbeg(nullptr),
+      _offset(0),
+      _tokpos(0),
+      _consumed(0),
+      _errpos(0)
+{}
+
+
+JsonPushParser::~JsonPushParser()
+{}
+
+// ------------------------------------------------------------------------- //
+
+/** Feeds the next fragment of the document to the parser. Returns
+  * JSON_FEED_COMPLETE once the root value is complete, in which case
+  * getConsumed() reports how much of this fragment was used, or
+  * JSON_FEED_ERROR on invalid input. Feeding text other than
+  * whitespace to a complete document is an error.
+ **/
+jfeed_t
+JsonPushParser::feed ( const char * buf, size_t len )
+{
+    const char * p   = buf;
+    const char * end = buf + len;
+
+    if ( _state == PUSH_ERROR )
+        return JSON_FEED_ERROR;
+
+    _buf      = buf;
+    _consumed = 0;
+
+    // a leading byte order mark, which may itself be split
+    while ( p < end && _bom < 3 && _bom == _offset + (p - buf) &&
+            (uint8_t) *p == JsonBom[_bom] )
+    {
+        ++p;
+        ++_bom;
+    }
+
+    if ( _bom > 0 && _bom < 3 && p < end )
+        this->setError(p, end);
+
+    while ( _state != PUSH_ERROR )
+    {
+        if ( _tok != PTOK_NONE )
+        {
+            bool  r;
+
+            if ( _tok == PTOK_SCALAR )
+                r = this->scanScalar(p, end);
+            else
+                r = this->scanString(p, end);
+
+            if ( ! r || _tok != PTOK_NONE || _state == PUSH_DONE )
+                break;
+        }
+
+        while ( p < end && JSON::IsSpace(*p) )
+            ++p;
+
+        if ( p == end )
+            break;
+
+        switch ( _state )
+        {
+            case PUSH_FIRST_VALUE:
+                if ( *p == TOKEN_ARRAY_END ) {
+                    this->endContainer(p++, end);
+                    break;
+                }
+                [[fallthrough]];
+            case PUSH_VALUE:
+                this->beginValue(p, end);
+                break;
+
+            case PUSH_FIRST_KEY:
+                if ( *p == TOKEN_OBJECT_END ) {
+                    this->endContainer(p++, end);
+                    break;
+                }
+                [[fallthrough]];
+            case PUSH_KEY:
+                if ( *p != TOKEN_STRING_SEPARATOR ) {
+                    this->setError(p, end);
+                    break;
+                }
+                _tok    = PTOK_KEY;
+                _tokbeg = p;
+                _tokpos = _offset + (p - _buf);
+                _escape = false;
+                ++p;
+                break;
+
+            case PUSH_ASSIGN:
+                if ( *p != TOKEN_NAME_SEPARATOR ) {
+                    this->setError(p, end);
+                    break;
+                }
+                _state = PUSH_VALUE;
+                ++p;
+                break;
+
+            case PUSH_NEXT:
+                if ( *p == TOKEN_VALUE_SEPARATOR ) {
+                    if ( _stack.back()->getType() == JSON_OBJECT )
+                        _state = PUSH_KEY;
+                    else
+                        _state = PUSH_VALUE;
+                    ++p;
+                } else {
+                    this->endContainer(p++, end);
+                }
+                break;
+
+            case PUSH_DONE:   // trailing text
+            default:
+                this->setError(p, end);
+                break;
+        }
+
+        if ( _state == PUSH_DONE )
+            break;
+    }
+
+    _consumed = p - buf;
+    _offset  += _consumed;
+
+    if ( _state == PUSH_ERROR )
+        return JSON_FEED_ERROR;
+    if ( _state == PUSH_DONE )
+        return JSON_FEED_COMPLETE;
+
+    return JSON_FEED_NEED_MORE;
+}
+
+
+/** Signals the end of the input. Completes a root value that was
+  * waiting on a delimiter, such as a number, and returns an error if
+  * the document is incomplete.
+ **/
+jfeed_t
+JsonPushParser::finish()
+{
+    if ( _state == PUSH_ERROR )
+        return JSON_FEED_ERROR;
+
+    if ( _tok == PTOK_SCALAR ) {
+        _tok = PTOK_NONE;
+        this->parseToken(_token.data(), _token.data() + _token.size());
+    }
+
+    if ( _state != PUSH_DONE && _state != PUSH_ERROR )
+        this->setError(_offset, "unexpected end of input");
+
+    if ( _state == PUSH_ERROR )
+        return JSON_FEED_ERROR;
+
+    return JSON_FEED_COMPLETE;
+}
+
+
+/** Discards the current document and state, ready for a new document */
+void
+JsonPushParser::reset()
+{
+    _json.clear();
+    _stack.clear();
+    _key.clear();
+    _token.clear();
+
+    _state    = PUSH_VALUE;
+    _tok      = PTOK_NONE;
+    _escape   = false;
+    _bom      = 0;
+    _buf      = nullptr;
+    _tokbeg   = nullptr;
+    _offset   = 0;
+    _tokpos   = 0;
+    _consumed = 0;
+    _errpos   = 0;
+    _errstr.clear();
+}
+
+
+void
+JsonPushParser::setValidateUtf8 ( bool validate )
+{
+    _json.setValidateUtf8(validate);
+    _parser.setValidateUtf8(validate);
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Starts the value at 'p'. Containers are attached to the tree
+  * immediately, while strings and scalars begin a token.
+ **/
+bool
+JsonPushParser::beginValue ( const char *& p, const char * end )
+{
+    if ( *p == TOKEN_OBJECT_BEGIN ) {
+        this->addValue(JsonCreate<JsonObject>(_json.getMemoryResource()));
+        ++p;
+        return true;
+    }
+
+    if ( *p == TOKEN_ARRAY_BEGIN ) {
+        this->addValue(JsonCreate<JsonArray>(_json.getMemoryResource()));
+        ++p;
+        return true;
+    }
+
+    if ( JSON::IsSeparator(*p) || *p == TOKEN_NAME_SEPARATOR )
+        return this->setError(p, end);
+
+    _tokbeg = p;
+    _tokpos = _offset + (p - _buf);
+
+    if ( *p == TOKEN_STRING_SEPARATOR ) {
+        _tok    = PTOK_STRING;
+        _escape = false;
+        ++p;
+    } else {
+        _tok = PTOK_SCALAR;
+    }
+
+    return true;
+}
+
+
+/** Scans for the closing quote of the current string token, honoring
+  * escapes split across fragments. The token is parsed once complete.
+ **/
+bool
+JsonPushParser::scanString ( const char *& p, const char * end )
+{
+    while ( p < end )
+    {
+        if ( _escape ) {
+            _escape = false;
+            ++p;
+            continue;
+        }
+
+        p = JsonKernels::Active().scanString(p, end);
+
+        if ( p == end )
+            break;
+
+        if ( *p == '\\' ) {
+            _escape = true;
+            ++p;
+        } else if ( *p == TOKEN_STRING_SEPARATOR ) {
+            return this->endToken(++p);
+        } else {
+            return this->setError(p, end);  // unescaped control character
+        }
+    }
+
+    // carry the partial token to the next fragment
+    if ( _tokbeg != nullptr )
+        _token.assign(_tokbeg, end - _tokbeg);
+    else
+        _token.append(_buf, end - _buf);
+
+    _tokbeg = nullptr;
+
+    return true;
+}
+
+
+/** Scans for the delimiter ending the current scalar token */
+bool
+JsonPushParser::scanScalar ( const char *& p, const char * end )
+{
+    while ( p < end )
+    {
+        char c = *p;
+
+        if ( JSON::IsSpace(c) || JSON::IsSeparator(c) || c == TOKEN_NAME_SEPARATOR ||
+             c == TOKEN_OBJECT_BEGIN || c == TOKEN_ARRAY_BEGIN || c == TOKEN_STRING_SEPARATOR )
+            return this->endToken(p);
+
+        ++p;
+    }
+
+    if ( _tokbeg != nullptr )
+        _token.assign(_tokbeg, end - _tokbeg);
+    else
+        _token.append(_buf, end - _buf);
+
+    _tokbeg = nullptr;
+
+    return true;
+}
+
+
+/** Completes the current token, which ends before 'p'. A token that
+  * began within this fragment is parsed in place, otherwise the rest
+  * of the token is appended to the carried portion.
+ **/
+bool
+JsonPushParser::endToken ( const char * p )
+{
+    _tok = PTOK_NONE;
+
+    if ( _tokbeg != nullptr ) {
+        const char * beg = _tokbeg;
+        _tokbeg = nullptr;
+        return this->parseToken(beg, p);
+    }
+
+    _token.append(_buf, p - _buf);
+
+    return this->parseToken(_token.data(), _token.data() + _token.size());
+}
+
+
+/** Parses the complete token in [beg, end) with the JsonParser, as
+  * either an object key or a string or scalar value.
+ **/
+bool
+JsonPushParser::parseToken ( const char * beg, const char * end )
+{
+    std::string_view  key;
+    bool              r;
+
+    _parser.reset(std::string_view(beg, end - beg));
+
+    if ( _state == PUSH_FIRST_KEY || _state == PUSH_KEY )
+    {
+        r = _parser.parseString(key);
+
+        if ( r ) {
+            _key.assign(key);
+            if ( ((JsonObject*) _stack.back())->exists(_key) )
+                return this->setError(_tokpos, _key);  // duplicate key
+            _state = PUSH_ASSIGN;
+        }
+    }
+    else
+    {
+        if ( _builder.getMemoryResource() != _json.getMemoryResource() )
+            _builder.setMemoryResource(_json.getMemoryResource());
+
+        _builder.reset();
+
+        if ( (r = _parser.parseValue()) )
+            this->addValue(_builder.release());
+    }
+
+    if ( r && ! _parser.atEnd() )
+        r = _parser.setError();
+
+    if ( ! r )
+        return this->setError(_tokpos + _parser.getErrorPos(), _parser.getErrorStr());
+
+    return true;
+}
+
+
+/** Attaches the value to the current container, or makes it the root.
+  * Containers are pushed on the stack to receive their own values.
+ **/
+void
+JsonPushParser::addValue ( JsonType * item )
+{
+    if ( _stack.empty() ) {
+        delete _json._root;
+        _json._root = item;
+    } else if ( _stack.back()->getType() == JSON_OBJECT ) {
+        ((JsonObject*) _stack.back())->insert(_key, item);
+    } else {
+        ((JsonArray*) _stack.back())->insert(item);
+    }
+
+    switch ( item->getType() ) {
+        case JSON_OBJECT:
+            _stack.push_back(item);
+            _state = PUSH_FIRST_KEY;
+            break;
+        case JSON_ARRAY:
+            _stack.push_back(item);
+            _state = PUSH_FIRST_VALUE;
+            break;
+        default:
+            _state = _stack.empty() ? PUSH_DONE : PUSH_NEXT;
+            break;
+    }
+}
+
+
+/** Closes the current container with the token at 'p' */
+bool
+JsonPushParser::endContainer ( const char * p, const char * end )
+{
+    json_t  t = _stack.back()->getType();
+
+    if ( ! ((*p == TOKEN_OBJECT_END && t == JSON_OBJECT) ||
+            (*p == TOKEN_ARRAY_END  && t == JSON_ARRAY)) )
+        return this->setError(p, end);
+
+    _stack.pop_back();
+    _state = _stack.empty() ? PUSH_DONE : PUSH_NEXT;
+
+    return true;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Records an error at 'p' within the current fragment */
+bool
+JsonPushParser::setError ( const char * p, const char * end )
+{
+    const char * from = (p - _buf < 5) ? _buf : p - 5;
+    const char * to   = ((size_t)(end - p) < TCAJSON_ERRSTRLEN) ? end : p + TCAJSON_ERRSTRLEN;
+
+    return this->setError(_offset + (p - _buf), std::string(from, to - from));
+}
+
+
+bool
+JsonPushParser::setError ( size_t pos, const std::string & errstr )
+{
+    _state  = PUSH_ERROR;
+    _tok    = PTOK_NONE;
+    _errpos = pos;
+    _errstr = errstr;
+
+    return false;
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONPUSHPARSER_CPP_
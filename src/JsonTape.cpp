@@ -0,0 +1,462 @@
+/**
+  * @file JsonTape.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONTAPE_CPP_
+
+#include "JsonTape.h"
+
+
+namespace tcajson {
+
+
+static const JsonTapeNode  JsonTapeNull = { JSON_NULL, 0, 0, 0, false, { 0 } };
+
+// ------------------------------------------------------------------------- //
+
+/** Appends a node for a value, counting it as an element of an open
+  * array. Object members are counted by their key instead.
+ **/
+inline JsonTapeNode&
+JsonTapeBuilder::add ( json_t t )
+{
+    std::vector<JsonTapeNode> & nodes = _tape._nodes;
+    uint32_t                    idx   = nodes.size();
+
+    if ( ! _stack.empty() && nodes[_stack.back()].type == JSON_ARRAY )
+        ++nodes[_stack.back()].len;
+
+    nodes.push_back(JsonTapeNode{ t, 0, idx + 1, 0, false, { 0 } });
+
+    return nodes.back();
+}
+
+
+inline void
+JsonTapeBuilder::open ( json_t t )
+{
+    uint32_t  idx = _tape._nodes.size();
+
+    this->add(t);
+    _stack.push_back(idx);
+}
+
+
+inline void
+JsonTapeBuilder::close()
+{
+    _tape._nodes[_stack.back()].next = _tape._nodes.size();
+    _stack.pop_back();
+}
+
+
+bool
+JsonTapeBuilder::startObject()
+{
+    this->open(JSON_OBJECT);
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::endObject()
+{
+    this->close();
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::startArray()
+{
+    this->open(JSON_ARRAY);
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::endArray()
+{
+    this->close();
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::key ( std::string_view k )
+{
+    ++_tape._nodes[_stack.back()].len;
+
+    return this->string(k);
+}
+
+
+/** Records a string or key. A view of the input is kept as an offset
+  * into it, while a string decoded by the tokenizer is copied to the
+  * pool.
+ **/
+bool
+JsonTapeBuilder::string ( std::string_view str )
+{
+    const char *   beg   = _tape._input.data();
+    const char *   end   = beg + _tape._input.size();
+    JsonTapeNode & n     = this->add(JSON_STRING);
+
+    n.len = str.size();
+
+    if ( str.data() >= beg && str.data() + str.size() <= end ) {
+        n.off = str.data() - beg;
+    } else {
+        n.pooled = true;
+        n.off    = _tape._pool.size();
+        _tape._pool.append(str);
+    }
+
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::integer ( int64_t val )
+{
+    JsonTapeNode & n = this->add(JSON_NUMBER);
+
+    n.ntype = JSON_NUMBER_INT64;
+    n.ival  = val;
+
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::uinteger ( uint64_t val )
+{
+    JsonTapeNode & n = this->add(JSON_NUMBER);
+
+    n.ntype = JSON_NUMBER_UINT64;
+    n.uval  = val;
+
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::number ( double val )
+{
+    JsonTapeNode & n = this->add(JSON_NUMBER);
+
+    n.ntype = JSON_NUMBER_DOUBLE;
+    n.dval  = val;
+
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::boolean ( bool b )
+{
+    this->add(JSON_BOOLEAN).bval = b;
+
+    return true;
+}
+
+
+bool
+JsonTapeBuilder::null()
+{
+    this->add(JSON_NULL);
+
+    return true;
+}
+
+// ------------------------------------------------------------------------- //
+
+JsonTape::JsonTape()
+    : _builder(*this),
+      _parser(_builder)
+{}
+
+
+JsonTape::~JsonTape()
+{}
+
+
+/** Validates the given document and records it onto the tape. The
+  * input is not copied and must remain unchanged while the tape is in
+  * use. On error the tape is left empty.
+ **/
+bool
+JsonTape::parse ( std::string_view str )
+{
+    this->clear();
+
+    _input = str;
+
+    if ( ! _parser.parse(str) ) {
+        this->clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+void
+JsonTape::clear()
+{
+    _nodes.clear();
+    _pool.clear();
+    _builder.reset();
+    _input = std::string_view();
+}
+
+
+/** Returns a cursor to the root value, which is not valid if the tape
+  * is empty.
+ **/
+JsonCursor
+JsonTape::getRoot() const
+{
+    if ( _nodes.empty() )
+        return JsonCursor();
+
+    return JsonCursor(this, 0);
+}
+
+// ------------------------------------------------------------------------- //
+
+const JsonTapeNode&
+JsonCursor::node() const
+{
+    if ( _tape == nullptr )
+        return JsonTapeNull;
+
+    return _tape->_nodes[_idx];
+}
+
+
+json_t
+JsonCursor::getType() const
+{
+    return this->node().type;
+}
+
+
+/** Returns the number of members or elements of a container */
+size_t
+JsonCursor::size() const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type == JSON_OBJECT || n.type == JSON_ARRAY )
+        return n.len;
+
+    return 0;
+}
+
+
+/** Returns the member of an object with the given key, skipping over
+  * the values of the other members.
+ **/
+JsonCursor
+JsonCursor::find ( std::string_view key ) const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_OBJECT )
+        return JsonCursor();
+
+    for ( uint32_t idx = _idx + 1; idx < n.next; idx = _tape->_nodes[idx + 1].next )
+    {
+        if ( _tape->getString(_tape->_nodes[idx]) == key )
+            return JsonCursor(_tape, idx + 1, idx);
+    }
+
+    return JsonCursor();
+}
+
+
+/** Returns the element of an array at the given index */
+JsonCursor
+JsonCursor::operator[] ( size_t index ) const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_ARRAY || index >= n.len )
+        return JsonCursor();
+
+    uint32_t idx = _idx + 1;
+
+    while ( index-- > 0 )
+        idx = _tape->_nodes[idx].next;
+
+    return JsonCursor(_tape, idx);
+}
+
+
+/** Iterates the elements of an array or the members of an object,
+  * where each member's key is available via getKey().
+ **/
+JsonCursor::iterator
+JsonCursor::begin() const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_OBJECT && n.type != JSON_ARRAY )
+        return iterator();
+
+    return iterator(_tape, _idx + 1, n.type == JSON_OBJECT);
+}
+
+
+JsonCursor::iterator
+JsonCursor::end() const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_OBJECT && n.type != JSON_ARRAY )
+        return iterator();
+
+    return iterator(_tape, n.next, n.type == JSON_OBJECT);
+}
+
+
+JsonCursor
+JsonCursor::iterator::operator*() const
+{
+    if ( _object )
+        return JsonCursor(_tape, _idx + 1, _idx);
+
+    return JsonCursor(_tape, _idx);
+}
+
+
+JsonCursor::iterator&
+JsonCursor::iterator::operator++()
+{
+    if ( _object )
+        _idx = _tape->_nodes[_idx + 1].next;
+    else
+        _idx = _tape->_nodes[_idx].next;
+
+    return *this;
+}
+
+// ------------------------------------------------------------------------- //
+
+std::string_view
+JsonCursor::getKey() const
+{
+    if ( _tape == nullptr || _key == 0 )
+        return std::string_view();
+
+    return _tape->getString(_tape->_nodes[_key]);
+}
+
+
+std::string_view
+JsonCursor::getString() const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_STRING )
+        return std::string_view();
+
+    return _tape->getString(n);
+}
+
+
+/** Returns a number as a signed integer, truncating a double */
+int64_t
+JsonCursor::getInteger() const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_NUMBER )
+        return 0;
+    if ( n.ntype == JSON_NUMBER_DOUBLE )
+        return static_cast<int64_t>(n.dval);
+
+    return n.ival;
+}
+
+
+/** Returns a number as an unsigned integer, truncating a double */
+uint64_t
+JsonCursor::getUnsigned() const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_NUMBER )
+        return 0;
+    if ( n.ntype == JSON_NUMBER_DOUBLE )
+        return static_cast<uint64_t>(n.dval);
+
+    return n.uval;
+}
+
+
+double
+JsonCursor::getDouble() const
+{
+    const JsonTapeNode & n = this->node();
+
+    if ( n.type != JSON_NUMBER )
+        return 0.0;
+    if ( n.ntype == JSON_NUMBER_INT64 )
+        return static_cast<double>(n.ival);
+    if ( n.ntype == JSON_NUMBER_UINT64 )
+        return static_cast<double>(n.uval);
+
+    return n.dval;
+}
+
+
+bool
+JsonCursor::getBoolean() const
+{
+    const JsonTapeNode & n = this->node();
+
+    return (n.type == JSON_BOOLEAN) && n.bval;
+}
+
+
+/** Builds the value at this cursor into a new tree of JsonTypes, owned
+  * by the caller. An invalid cursor materializes as null. Returns
+  * nullptr if an object holds a duplicate key.
+ **/
+JsonType*
+JsonCursor::materialize() const
+{
+    JsonTreeBuilder  builder;
+
+    if ( ! this->accept(builder) )
+        return nullptr;
+
+    return builder.release();
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONTAPE_CPP_
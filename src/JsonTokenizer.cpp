@@ -0,0 +1,549 @@
+/**
+  * @file JsonTokenizer.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONTOKENIZER_CPP_
+
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+
+#include "JsonTokenizer.h"
+#include "JSON.h"
+
+
+namespace tcajson {
+
+
+JsonTokenizer::JsonTokenizer()
+    : _beg(nullptr),
+      _pos(nullptr),
+      _end(nullptr),
+      _ipos(nullptr),
+      _iend(nullptr),
+      _isize(nullptr),
+      _isend(nullptr),
+      _kernels(&JsonKernels::Active()),
+      _utf8(false),
+      _errpos(0),
+      _errlen(TCAJSON_ERRSTRLEN)
+{}
+
+
+JsonTokenizer::~JsonTokenizer()
+{}
+
+// ------------------------------------------------------------------------- //
+
+/** Positions the tokenizer at the start of the given input, which is
+  * not copied and must outlive the parse. Any index is dropped.
+ **/
+void
+JsonTokenizer::reset ( std::string_view str )
+{
+    _kernels = &JsonKernels::Active();
+    _beg     = str.data();
+    _pos     = _beg;
+    _end     = _beg + str.size();
+    _ipos    = nullptr;
+    _iend    = nullptr;
+    _isize   = nullptr;
+    _isend   = nullptr;
+}
+
+
+/** Sets the structural index of the current input, as built by
+  * JsonIndex::build(), for skipSpace() to follow and nextArraySize()
+  * to report from. A null index returns to scanning the whitespace.
+ **/
+void
+JsonTokenizer::setIndex ( const JsonIndex * index )
+{
+    if ( index == nullptr ) {
+        _ipos  = _iend  = nullptr;
+        _isize = _isend = nullptr;
+        return;
+    }
+
+    _ipos  = index->positions().data();
+    _iend  = _ipos + index->size();
+    _isize = index->arraySizes().data();
+    _isend = _isize + index->arraySizes().size();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Parses a JSON string, setting 'str' to its decoded value. A string
+  * without escapes is returned as a view of the input, otherwise it is
+  * decoded into a scratch buffer owned by the tokenizer. Either way
+  * the view is only valid until the next token is parsed.
+ **/
+bool
+JsonTokenizer::parseString ( std::string_view & str )
+{
+    const char * q;
+
+    if ( _pos == _end || *_pos != TOKEN_STRING_SEPARATOR )
+        return this->setError();
+
+    ++_pos;
+
+    q = _kernels->scanString(_pos, _end);
+
+    if ( q < _end && *q == TOKEN_STRING_SEPARATOR )
+    {
+        if ( _utf8 && q > _pos ) {
+            const char * bad = _kernels->validUtf8(_pos, q);
+            if ( bad < q ) {
+                _pos = bad;
+                return this->setError();
+            }
+        }
+
+        str  = std::string_view(_pos, q - _pos);
+        _pos = q + 1;
+
+        return true;
+    }
+
+    if ( ! this->parseEscaped(q) )
+        return false;
+
+    str = _scratch;
+
+    return true;
+}
+
+
+/** Decodes the remainder of a string holding escapes into the scratch
+  * buffer, with 'q' the first quote, backslash or control character.
+  * The string kernel locates each following one so that runs of plain
+  * characters are appended at once. Escapes, including \\u escapes and
+  * UTF-16 surrogate pairs, are decoded as UTF-8. Unescaped control
+  * characters are rejected.
+ **/
+bool
+JsonTokenizer::parseEscaped ( const char * q )
+{
+    uint32_t  cp;
+
+    _scratch.clear();
+
+    while ( q < _end )
+    {
+        if ( _utf8 && q > _pos ) {
+            const char * bad = _kernels->validUtf8(_pos, q);
+            if ( bad < q ) {
+                _pos = bad;
+                return this->setError();
+            }
+        }
+
+        _scratch.append(_pos, q - _pos);
+        _pos = q;
+
+        if ( *_pos == TOKEN_STRING_SEPARATOR ) {
+            ++_pos;
+            return true;
+        }
+
+        if ( *_pos != '\\' )   // unescaped control character
+            return this->setError();
+
+        if ( ++_pos == _end )
+            break;
+
+        switch ( *_pos )
+        {
+            case '"':
+            case '/':
+            case '\\':
+                _scratch.push_back(*_pos);
+                break;
+            case 'b':
+                _scratch.push_back('\b');
+                break;
+            case 'f':
+                _scratch.push_back('\f');
+                break;
+            case 'n':
+                _scratch.push_back('\n');
+                break;
+            case 'r':
+                _scratch.push_back('\r');
+                break;
+            case 't':
+                _scratch.push_back('\t');
+                break;
+            case 'u':
+                if ( ! this->parseUnicode(cp) )
+                    return false;
+                JSON::AppendUtf8(_scratch, cp);
+                q = _kernels->scanString(_pos, _end);
+                continue;
+            default:   // error
+                return this->setError();
+        }
+
+        ++_pos;
+        q = _kernels->scanString(_pos, _end);
+    }
+
+    _pos = _end;
+
+    return this->setError();
+}
+
+
+/** Decodes a \\u escape, with the input positioned at the 'u'. A high
+  * surrogate must be followed by an escaped low surrogate, and the pair
+  * is combined into a single code point. Leaves the input positioned
+  * after the escape.
+ **/
+bool
+JsonTokenizer::parseUnicode ( uint32_t & cp )
+{
+    uint32_t lo;
+
+    ++_pos;
+
+    if ( ! this->parseHex(cp) )
+        return false;
+
+    if ( cp >= 0xDC00 && cp <= 0xDFFF )
+        return this->setError();  // unpaired low surrogate
+
+    if ( cp < 0xD800 || cp > 0xDBFF )
+        return true;
+
+    if ( _end - _pos < 2 || _pos[0] != '\\' || _pos[1] != 'u' )
+        return this->setError();  // unpaired high surrogate
+
+    _pos += 2;
+
+    if ( ! this->parseHex(lo) )
+        return false;
+
+    if ( lo < 0xDC00 || lo > 0xDFFF )
+        return this->setError();
+
+    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+
+    return true;
+}
+
+
+/** Parses the four hex digits of a \\u escape */
+bool
+JsonTokenizer::parseHex ( uint32_t & val )
+{
+    val = 0;
+
+    if ( _end - _pos < 4 )
+        return this->setError();
+
+    for ( int i = 0; i < 4; ++i, ++_pos )
+    {
+        char c = *_pos;
+
+        val <<= 4;
+
+        if ( c >= '0' && c <= '9' )
+            val |= c - '0';
+        else if ( c >= 'a' && c <= 'f' )
+            val |= c - 'a' + 10;
+        else if ( c >= 'A' && c <= 'F' )
+            val |= c - 'A' + 10;
+        else
+            return this->setError();
+    }
+
+    return true;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Parses a JSON number, setting 'type' to its representation. The
+  * token is validated against the RFC 8259 number grammar while it is
+  * scanned. Integers without a fraction or exponent that fit in 64 bits
+  * are accumulated during the scan and set exactly in 'ival', a negative
+  * value as its two's complement, all other numbers are converted in
+  * place with std::from_chars and set in 'val'. A number too large for
+  * a double is rejected, as the infinity it would become has no JSON
+  * form.
+ **/
+bool
+JsonTokenizer::parseNumber ( jnum_t & type, uint64_t & ival, double & val )
+{
+    const char * p      = _pos;
+    const char * digits;
+    bool         neg    = false;
+    bool         isint  = true;
+
+    ival = 0;
+    val  = 0.0;
+
+    if ( p < _end && *p == '-' ) {
+        neg = true;
+        ++p;
+    }
+
+    if ( p == _end || ! IsDigit(*p) ) {
+        _pos = p;
+        return this->setError();
+    }
+
+    digits = p;
+
+    // int: a leading zero may not be followed by more digits
+    if ( *p == '0' )
+        ++p;
+    else
+        while ( p < _end && IsDigit(*p) )
+            ival = (ival * 10) + (*p++ - '0');
+
+    // frac
+    if ( p < _end && *p == '.' ) {
+        isint = false;
+        if ( ++p == _end || ! IsDigit(*p) ) {
+            _pos = p;
+            return this->setError();
+        }
+        while ( p < _end && IsDigit(*p) )
+            ++p;
+    }
+
+    // exp
+    if ( p < _end && (*p == 'e' || *p == 'E') ) {
+        isint = false;
+        if ( ++p < _end && (*p == '-' || *p == '+') )
+            ++p;
+        if ( p == _end || ! IsDigit(*p) ) {
+            _pos = p;
+            return this->setError();
+        }
+        while ( p < _end && IsDigit(*p) )
+            ++p;
+    }
+
+    // up to 19 digits can not overflow the accumulator
+    if ( isint && (p - digits) > 19 ) {
+        if ( std::from_chars(digits, p, ival).ec != std::errc() )
+            isint = false;
+    }
+
+    if ( isint && neg && ival == 0 )
+        isint = false;  // keep -0 as a double
+
+    if ( isint && neg && ival > (uint64_t) INT64_MAX + 1 )
+        isint = false;
+
+    if ( isint ) {
+        if ( neg )
+            ival = 0 - ival;
+        type = (neg || ival <= (uint64_t) INT64_MAX)
+             ? JSON_NUMBER_INT64 : JSON_NUMBER_UINT64;
+    } else {
+        std::from_chars_result res = std::from_chars(_pos, p, val);
+
+        // out of range values underflow as with strtod, or overflow
+        if ( res.ec == std::errc::result_out_of_range ) {
+            val = std::strtod(std::string(_pos, p).c_str(), nullptr);
+            if ( std::isinf(val) )
+                return this->setError();
+        }
+
+        type = JSON_NUMBER_DOUBLE;
+    }
+
+    _pos = p;
+
+    return true;
+}
+
+
+/** Parses a JSON boolean literal */
+bool
+JsonTokenizer::parseBoolean ( bool & b )
+{
+    size_t len = _end - _pos;
+
+    if ( len >= 4 && std::string_view(_pos, 4) == "true" ) {
+        _pos += 4;
+        b = true;
+        return true;
+    }
+
+    if ( len >= 5 && std::string_view(_pos, 5) == "false" ) {
+        _pos += 5;
+        b = false;
+        return true;
+    }
+
+    return this->setError();
+}
+
+
+/** Parses the JSON null literal */
+bool
+JsonTokenizer::parseNull()
+{
+    if ( _end - _pos >= 4 && std::string_view(_pos, 4) == "null" ) {
+        _pos += 4;
+        return true;
+    }
+
+    return this->setError();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Skips the next value without building or converting it. Strings
+  * are scanned to the closing quote without decoding their escapes,
+  * and containers only to their matching bracket, so the contents of a
+  * skipped value are not validated beyond the balance of its brackets
+  * and quotes.
+ **/
+bool
+JsonTokenizer::skipValue()
+{
+    this->skipSpace();
+
+    if ( _pos == _end )
+        return this->setError();
+
+    if ( *_pos == TOKEN_STRING_SEPARATOR )
+        return this->skipString();
+
+    if ( *_pos != TOKEN_OBJECT_BEGIN && *_pos != TOKEN_ARRAY_BEGIN )
+    {
+        const char * p = _pos;
+
+        while ( p < _end && ! IsSpace(*p) && *p != TOKEN_VALUE_SEPARATOR &&
+                *p != TOKEN_OBJECT_END && *p != TOKEN_ARRAY_END &&
+                *p != TOKEN_NAME_SEPARATOR )
+            ++p;
+
+        if ( p == _pos )
+            return this->setError();
+
+        _pos = p;
+
+        return true;
+    }
+
+    _nest.clear();
+
+    while ( _pos < _end )
+    {
+        if ( (JsonCharTable[(uint8_t) *_pos] & JSON_CC_NEST) == 0 ) {
+            ++_pos;
+            continue;
+        }
+
+        switch ( *_pos )
+        {
+            case TOKEN_STRING_SEPARATOR:
+                if ( ! this->skipString() )
+                    return false;
+                continue;
+
+            case TOKEN_OBJECT_BEGIN:
+                _nest.push_back(TOKEN_OBJECT_END);
+                break;
+
+            case TOKEN_ARRAY_BEGIN:
+                _nest.push_back(TOKEN_ARRAY_END);
+                break;
+
+            case TOKEN_OBJECT_END:
+            case TOKEN_ARRAY_END:
+                if ( *_pos != _nest.back() )
+                    return this->setError();
+                _nest.pop_back();
+                if ( _nest.empty() ) {
+                    ++_pos;
+                    return true;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        ++_pos;
+    }
+
+    return this->setError();
+}
+
+
+/** Skips the string at the current position, honoring escaped quotes */
+bool
+JsonTokenizer::skipString()
+{
+    ++_pos;
+
+    while ( (_pos = _kernels->scanString(_pos, _end)) < _end )
+    {
+        if ( *_pos == TOKEN_STRING_SEPARATOR ) {
+            ++_pos;
+            return true;
+        }
+
+        if ( *_pos == '\\' && ++_pos == _end )
+            break;
+
+        ++_pos;
+    }
+
+    _pos = _end;
+
+    return this->setError();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Sets the error string, recording the position within the buffer
+  * where the parse error occurred. Always returns false so that
+  * parse methods may simply return the result.
+ **/
+bool
+JsonTokenizer::setError()
+{
+    const char * from;
+    const char * to;
+
+    _errpos = _pos - _beg;
+    from    = (_errpos < 5) ? _beg : _pos - 5;
+    to      = ((size_t)(_end - _pos) < _errlen) ? _end : _pos + _errlen;
+
+    _errstr.assign(from, to - from);
+
+    return false;
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONTOKENIZER_CPP_
@@ -0,0 +1,801 @@
+/**
+  * @file JsonValue.cpp
+  *
+  * Copyright (c) 2012-2026 Timothy Charlton Arland <tcarland@gmail.com>
+  *
+  * @section LICENSE
+  *
+  * This file is part of tcajson.
+  *
+  * tcajson is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU Lesser General Public License as
+  * published by the Free Software Foundation, either version 3 of
+  * the License, or (at your option) any later version.
+  *
+  * tcajson is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU Lesser General Public License for more details.
+  *
+  * You should have received a copy of the GNU Lesser General Public
+  * License along with tcajson.
+  * If not, see <http://www.gnu.org/licenses/>.
+**/
+#define _TCAJSON_JSONVALUE_CPP_
+
+#include <sstream>
+#include <stdexcept>
+
+#include "JsonValue.h"
+#include "JsonTreeBuilder.hpp"
+#include "JSON.h"
+
+
+namespace tcajson {
+
+
+static_assert(sizeof(JsonValue) == 16, "JsonValue is not 16 bytes");
+
+static constinit const JsonValue  JsonValueNull;
+
+// ------------------------------------------------------------------------- //
+
+JsonValue::JsonValue ( bool b ) noexcept
+    : JsonValue()
+{
+    _type    = JSON_BOOLEAN;
+    _data[0] = b;
+}
+
+
+JsonValue::JsonValue ( double val ) noexcept
+    : JsonValue()
+{
+    _type = JSON_NUMBER;
+    _sub  = JSON_NUMBER_DOUBLE;
+    this->store(val);
+}
+
+
+/** Constructs a string value. Strings longer than the inline size are
+  * copied into a payload drawn from the allocator. Throws a
+  * runtime_error if the string is longer than UINT32_MAX.
+ **/
+JsonValue::JsonValue ( std::string_view str, const JsonAllocator & alloc )
+    : JsonValue()
+{
+    _type = JSON_STRING;
+
+    if ( str.size() <= TCAJSON_VALUE_INLINESZ ) {
+        std::memcpy(_data, str.data(), str.size());
+        _sub = str.size();
+        return;
+    }
+
+    if ( str.size() > UINT32_MAX )
+        throw ( std::runtime_error("JsonValue string is too long") );
+
+    std::pmr::memory_resource * mr = alloc.resource();
+
+    void *   buf = mr->allocate(sizeof(String) + str.size(), alignof(String));
+    String * hdr = new (buf) String{ mr, (uint32_t) str.size(), 1 };
+
+    std::memcpy((char*)(hdr + 1), str.data(), str.size());
+
+    _sub = StringHeap;
+    this->store(hdr);
+}
+
+
+/** Returns a string value that refers to the given characters, which
+  * must outlive the value, without copying them. A string that fits
+  * inline is copied instead, with the allocator.
+ **/
+JsonValue
+JsonValue::Borrow ( std::string_view str, const JsonAllocator & alloc )
+{
+    if ( str.size() <= TCAJSON_VALUE_INLINESZ || str.size() > UINT32_MAX )
+        return JsonValue(str, alloc);
+
+    JsonValue  val;
+    uint32_t   len = str.size();
+
+    val._type = JSON_STRING;
+    val._sub  = StringView;
+    val.store(str.data());
+    std::memcpy(val._data + sizeof(const char*), &len, sizeof(len));
+
+    return val;
+}
+
+
+JsonValue::JsonValue ( const char * str, const JsonAllocator & alloc )
+    : JsonValue(std::string_view(str), alloc)
+{}
+
+
+/** Constructs the empty value of the given type: an empty object,
+  * array or string, zero, or false.
+ **/
+JsonValue::JsonValue ( json_t t, const JsonAllocator & alloc )
+    : JsonValue()
+{
+    std::pmr::memory_resource * mr = alloc.resource();
+
+    switch ( t ) {
+        case JSON_OBJECT: {
+            void * obj = mr->allocate(sizeof(SharedObject), alignof(SharedObject));
+            this->store<Object*>(new (obj) SharedObject(mr));
+            break;
+        }
+        case JSON_ARRAY: {
+            void * ary = mr->allocate(sizeof(SharedArray), alignof(SharedArray));
+            this->store<Array*>(new (ary) SharedArray(mr));
+            break;
+        }
+        case JSON_NUMBER:
+            this->setInteger(0);
+            break;
+        default:
+            break;
+    }
+
+    _type = t;
+}
+
+
+/** JsonValue copy constructor, drawing the copy from the default resource */
+JsonValue::JsonValue ( const JsonValue & val )
+    : JsonValue(val, JsonAllocator())
+{}
+
+
+/** Copies the value, drawing any payloads from the given allocator */
+JsonValue::JsonValue ( const JsonValue & val, const JsonAllocator & alloc )
+    : JsonValue()
+{
+    switch ( val.getType() ) {
+        case JSON_OBJECT: {
+            JsonValue  obj(JSON_OBJECT, alloc);
+            Object &   members = obj.getObject();
+
+            members.reserve(val.size());
+            for ( const Member & m : val.getObject() )
+                members.emplace_back(JsonValue(m.first, alloc), JsonValue(m.second, alloc));
+
+            *this = std::move(obj);
+            break;
+        }
+        case JSON_ARRAY: {
+            JsonValue  ary(JSON_ARRAY, alloc);
+            Array &    items = ary.getArray();
+
+            items.reserve(val.size());
+            for ( const JsonValue & v : val.getArray() )
+                items.push_back(JsonValue(v, alloc));
+
+            *this = std::move(ary);
+            break;
+        }
+        case JSON_STRING:
+            if ( val._sub == StringHeap || val._sub == StringView ) {
+                *this = JsonValue(val.getString(), alloc);
+                break;
+            }
+            [[fallthrough]];
+        default:
+            std::memcpy((void*) this, (const void*) &val, sizeof(JsonValue));
+            break;
+    }
+}
+
+
+JsonValue::JsonValue ( JsonValue && val ) noexcept
+{
+    std::memcpy((void*) this, (const void*) &val, sizeof(JsonValue));
+    val._type = JSON_NULL;
+}
+
+
+JsonValue::~JsonValue()
+{
+    this->release();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Copies the value, drawing any payloads from the resource of this
+  * value, or the default resource if it has none. The copy is taken
+  * before the payload of this value is released, as 'val' may be an
+  * element or member of it, shared or not.
+ **/
+JsonValue&
+JsonValue::operator= ( const JsonValue & val )
+{
+    if ( this == &val )
+        return *this;
+
+    std::pmr::memory_resource * mr = this->getMemoryResource();
+
+    if ( mr == nullptr )
+        mr = std::pmr::get_default_resource();
+
+    JsonValue  copy(val, mr);
+
+    return *this = std::move(copy);
+}
+
+
+/** Takes the value of 'val', which may be an element or member of
+  * this value, and so is moved out before the payload is released.
+ **/
+JsonValue&
+JsonValue::operator= ( JsonValue && val ) noexcept
+{
+    if ( this == &val )
+        return *this;
+
+    JsonValue  moved(std::move(val));
+
+    this->release();
+    std::memcpy((void*) this, (const void*) &moved, sizeof(JsonValue));
+    moved._type = JSON_NULL;
+
+    return *this;
+}
+
+
+/** Returns the count of values sharing the payload, or nullptr for a
+  * value without one.
+ **/
+std::atomic<uint32_t>*
+JsonValue::refs() const
+{
+    switch ( _type ) {
+        case JSON_OBJECT:
+            return &static_cast<SharedObject*>(this->load<Object*>())->refs;
+        case JSON_ARRAY:
+            return &static_cast<SharedArray*>(this->load<Array*>())->refs;
+        case JSON_STRING:
+            if ( _sub == StringHeap )
+                return &this->load<String*>()->refs;
+            break;
+        default:
+            break;
+    }
+
+    return nullptr;
+}
+
+
+/** Frees the payload of the value, unless it is still shared, leaving
+  * the value null.
+ **/
+void
+JsonValue::release() noexcept
+{
+    std::atomic<uint32_t> *     cnt = this->refs();
+    std::pmr::memory_resource * mr;
+
+    if ( cnt == nullptr || (cnt->load(std::memory_order_acquire) != 1
+            && cnt->fetch_sub(1, std::memory_order_acq_rel) != 1) ) {
+        _type = JSON_NULL;
+        _sub  = 0;
+        return;
+    }
+
+    switch ( _type ) {
+        case JSON_OBJECT: {
+            SharedObject * obj = static_cast<SharedObject*>(this->load<Object*>());
+            mr = obj->get_allocator().resource();
+            obj->~SharedObject();
+            mr->deallocate(obj, sizeof(SharedObject), alignof(SharedObject));
+            break;
+        }
+        case JSON_ARRAY: {
+            SharedArray * ary = static_cast<SharedArray*>(this->load<Array*>());
+            mr = ary->get_allocator().resource();
+            ary->~SharedArray();
+            mr->deallocate(ary, sizeof(SharedArray), alignof(SharedArray));
+            break;
+        }
+        case JSON_STRING: {
+            String * hdr = this->load<String*>();
+            hdr->mr->deallocate(hdr, sizeof(String) + hdr->len, alignof(String));
+            break;
+        }
+        default:
+            break;
+    }
+
+    _type = JSON_NULL;
+    _sub  = 0;
+}
+
+
+/** Returns a value sharing the payload of this one, without copying
+  * it. A borrowed string is shared as a view of the same characters.
+ **/
+JsonValue
+JsonValue::share() const noexcept
+{
+    std::atomic<uint32_t> * cnt = this->refs();
+    JsonValue               val;
+
+    if ( cnt != nullptr )
+        cnt->fetch_add(1, std::memory_order_relaxed);
+
+    std::memcpy((void*) &val, (const void*) this, sizeof(JsonValue));
+
+    return val;
+}
+
+
+/** Returns true if the payload of this value is shared with another */
+bool
+JsonValue::isShared() const
+{
+    std::atomic<uint32_t> * cnt = this->refs();
+
+    return cnt != nullptr && cnt->load(std::memory_order_acquire) > 1;
+}
+
+
+/** Gives a shared array or object its own copy of the container, from
+  * the same resource, whose members share those of the original.
+ **/
+void
+JsonValue::unshare()
+{
+    if ( (_type != JSON_OBJECT && _type != JSON_ARRAY) || ! this->isShared() )
+        return;
+
+    JsonValue  copy(this->getType(), this->getMemoryResource());
+
+    if ( _type == JSON_OBJECT ) {
+        const Object & src = *this->load<Object*>();
+        Object &       dst = *copy.load<Object*>();
+
+        dst.reserve(src.size());
+        for ( const Member & m : src )
+            dst.emplace_back(m.first.share(), m.second.share());
+    } else {
+        const Array & src = *this->load<Array*>();
+        Array &       dst = *copy.load<Array*>();
+
+        dst.reserve(src.size());
+        for ( const JsonValue & v : src )
+            dst.push_back(v.share());
+    }
+
+    *this = std::move(copy);
+}
+
+// ------------------------------------------------------------------------- //
+
+jnum_t
+JsonValue::getNumberType() const
+{
+    if ( _type != JSON_NUMBER )
+        return JSON_NUMBER_DOUBLE;
+    return (jnum_t) _sub;
+}
+
+
+bool
+JsonValue::isInteger() const
+{
+    return _type == JSON_NUMBER && _sub != JSON_NUMBER_DOUBLE;
+}
+
+
+/** Returns the number of members or elements of a container, or the
+  * length of a string.
+ **/
+size_t
+JsonValue::size() const
+{
+    switch ( _type ) {
+        case JSON_OBJECT:
+            return this->load<Object*>()->size();
+        case JSON_ARRAY:
+            return this->load<Array*>()->size();
+        case JSON_STRING:
+            return this->getString().size();
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+// ------------------------------------------------------------------------- //
+
+std::string_view
+JsonValue::getString() const
+{
+    if ( _type != JSON_STRING )
+        return std::string_view();
+
+    if ( _sub == StringView ) {
+        uint32_t  len;
+        std::memcpy(&len, _data + sizeof(const char*), sizeof(len));
+        return std::string_view(this->load<const char*>(), len);
+    }
+
+    if ( _sub != StringHeap )
+        return std::string_view((const char*) _data, _sub);
+
+    const String * hdr = this->load<const String*>();
+
+    return std::string_view((const char*)(hdr + 1), hdr->len);
+}
+
+
+/** Returns the value as a signed integer, truncating a double */
+int64_t
+JsonValue::getInteger() const
+{
+    if ( _type != JSON_NUMBER )
+        return 0;
+    if ( _sub == JSON_NUMBER_DOUBLE )
+        return static_cast<int64_t>(this->load<double>());
+    return this->load<int64_t>();
+}
+
+
+/** Returns the value as an unsigned integer, truncating a double */
+uint64_t
+JsonValue::getUnsigned() const
+{
+    if ( _type != JSON_NUMBER )
+        return 0;
+    if ( _sub == JSON_NUMBER_DOUBLE )
+        return static_cast<uint64_t>(this->load<double>());
+    return this->load<uint64_t>();
+}
+
+
+double
+JsonValue::getDouble() const
+{
+    if ( _type != JSON_NUMBER )
+        return 0.0;
+    if ( _sub == JSON_NUMBER_INT64 )
+        return static_cast<double>(this->load<int64_t>());
+    if ( _sub == JSON_NUMBER_UINT64 )
+        return static_cast<double>(this->load<uint64_t>());
+    return this->load<double>();
+}
+
+
+bool
+JsonValue::getBoolean() const
+{
+    return _type == JSON_BOOLEAN && _data[0] != 0;
+}
+
+
+void
+JsonValue::setInteger ( int64_t val ) noexcept
+{
+    this->release();
+    _type = JSON_NUMBER;
+    _sub  = JSON_NUMBER_INT64;
+    this->store(val);
+}
+
+
+void
+JsonValue::setUnsigned ( uint64_t val ) noexcept
+{
+    this->release();
+    _type = JSON_NUMBER;
+    _sub  = (val > static_cast<uint64_t>(INT64_MAX))
+          ? JSON_NUMBER_UINT64 : JSON_NUMBER_INT64;
+    this->store(val);
+}
+
+// ------------------------------------------------------------------------- //
+
+const JsonValue&
+JsonValue::operator[] ( std::string_view key ) const
+{
+    const JsonValue * val = this->find(key);
+
+    if ( val == nullptr )
+        return JsonValueNull;
+    return *val;
+}
+
+
+const JsonValue&
+JsonValue::operator[] ( size_t index ) const
+{
+    if ( _type != JSON_ARRAY || index >= this->size() )
+        return JsonValueNull;
+    return (*this->load<Array*>())[index];
+}
+
+
+/** Returns the first member with the given key, or nullptr */
+JsonValue*
+JsonValue::find ( std::string_view key )
+{
+    this->unshare();
+
+    return const_cast<JsonValue*>(std::as_const(*this).find(key));
+}
+
+
+const JsonValue*
+JsonValue::find ( std::string_view key ) const
+{
+    if ( _type != JSON_OBJECT )
+        return nullptr;
+
+    for ( const Member & m : *this->load<Object*>() ) {
+        if ( m.first.getString() == key )
+            return &m.second;
+    }
+
+    return nullptr;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Returns the elements of an array, copying a shared array first.
+  * Throws a runtime_error if the value is not an array.
+ **/
+JsonValue::Array&
+JsonValue::getArray()
+{
+    std::as_const(*this).getArray();
+    this->unshare();
+
+    return *this->load<Array*>();
+}
+
+
+const JsonValue::Array&
+JsonValue::getArray() const
+{
+    if ( _type != JSON_ARRAY )
+        throw ( std::runtime_error("JsonValue is not an array: "
+                    + JSON::TypeToString(this->getType())) );
+    return *this->load<Array*>();
+}
+
+
+/** Returns the members of an object, copying a shared object first.
+  * Throws a runtime_error if the value is not an object.
+ **/
+JsonValue::Object&
+JsonValue::getObject()
+{
+    std::as_const(*this).getObject();
+    this->unshare();
+
+    return *this->load<Object*>();
+}
+
+
+const JsonValue::Object&
+JsonValue::getObject() const
+{
+    if ( _type != JSON_OBJECT )
+        throw ( std::runtime_error("JsonValue is not an object: "
+                    + JSON::TypeToString(this->getType())) );
+    return *this->load<Object*>();
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Inserts a member with the given key into an object, returning the
+  * inserted value. Throws a runtime_error if the value is not an
+  * object or the key already exists.
+ **/
+JsonValue&
+JsonValue::insert ( std::string_view key, JsonValue && val )
+{
+    Object & obj = this->getObject();
+
+    if ( this->find(key) != nullptr )
+        throw ( std::runtime_error("JsonValue::insert() Item already exists: "
+                    + std::string(key)) );
+
+    obj.emplace_back(JsonValue(key, obj.get_allocator().resource()), std::move(val));
+
+    return obj.back().second;
+}
+
+
+/** Appends an element to an array, returning the inserted value.
+  * Throws a runtime_error if the value is not an array.
+ **/
+JsonValue&
+JsonValue::insert ( JsonValue && val )
+{
+    Array & ary = this->getArray();
+
+    ary.push_back(std::move(val));
+
+    return ary.back();
+}
+
+
+/** Returns the memory resource of the payload, or nullptr for a value
+  * held inline.
+ **/
+std::pmr::memory_resource*
+JsonValue::getMemoryResource() const
+{
+    switch ( _type ) {
+        case JSON_OBJECT:
+            return this->load<Object*>()->get_allocator().resource();
+        case JSON_ARRAY:
+            return this->load<Array*>()->get_allocator().resource();
+        case JSON_STRING:
+            if ( _sub == StringHeap )
+                return this->load<String*>()->mr;
+            break;
+        default:
+            break;
+    }
+
+    return nullptr;
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Converts the value to a JSON formatted string, as JSON::ToString()
+  * does for JsonTypes. A string is quoted only if 'asJson' is true.
+ **/
+std::string
+JsonValue::toString ( bool asJson ) const
+{
+    std::string  str;
+
+    this->toString(str, asJson);
+
+    return str;
+}
+
+
+void
+JsonValue::toString ( std::string & str, bool asJson ) const
+{
+    size_t  i = 1;
+
+    switch ( _type ) {
+        case JSON_OBJECT:
+            str.push_back(TOKEN_OBJECT_BEGIN);
+            str.push_back(TOKEN_WS);
+            for ( const Member & m : this->getObject() ) {
+                m.first.toString(str, true);
+                str.append(" : ");
+                m.second.toString(str, true);
+                if ( i++ < this->size() )
+                    str.append(", ");
+            }
+            str.push_back(TOKEN_WS);
+            str.push_back(TOKEN_OBJECT_END);
+            break;
+
+        case JSON_ARRAY:
+            str.push_back(TOKEN_ARRAY_BEGIN);
+            str.push_back(TOKEN_WS);
+            for ( const JsonValue & v : this->getArray() ) {
+                v.toString(str, true);
+                if ( i++ < this->size() )
+                    str.append(", ");
+            }
+            str.push_back(TOKEN_WS);
+            str.push_back(TOKEN_ARRAY_END);
+            break;
+
+        case JSON_STRING:
+            if ( asJson ) {
+                str.push_back(TOKEN_STRING_SEPARATOR);
+                str.append(JsonEscape(this->getString()));
+                str.push_back(TOKEN_STRING_SEPARATOR);
+            } else {
+                str.append(this->getString());
+            }
+            break;
+
+        case JSON_NUMBER:
+            if ( _sub == JSON_NUMBER_INT64 ) {
+                str.append(std::to_string(this->getInteger()));
+            } else if ( _sub == JSON_NUMBER_UINT64 ) {
+                str.append(std::to_string(this->getUnsigned()));
+            } else {
+                std::ostringstream  num;
+                num << this->getDouble();
+                str.append(num.str());
+            }
+            break;
+
+        case JSON_BOOLEAN:
+            str.append(this->getBoolean() ? "true" : "false");
+            break;
+
+        case JSON_NULL:
+        default:
+            str.append("null");
+            break;
+    }
+}
+
+// ------------------------------------------------------------------------- //
+
+/** Builds a tree of JsonTypes from the value, allocated with the
+  * given allocator, which is owned by the caller.
+ **/
+JsonType*
+JsonValue::materialize ( const JsonAllocator & alloc ) const
+{
+    JsonTreeBuilder  builder;
+
+    builder.setMemoryResource(alloc.resource());
+
+    if ( ! this->accept(builder) )
+        return nullptr;
+
+    return builder.release();
+}
+
+
+/** Converts a tree of JsonTypes to a JsonValue, drawing its payloads
+  * from the given allocator.
+ **/
+JsonValue
+JsonValue::FromType ( const JsonType * item, const JsonAllocator & alloc )
+{
+    switch ( item->getType() ) {
+        case JSON_OBJECT: {
+            const JsonObject * obj = (const JsonObject*) item;
+            JsonValue          val(JSON_OBJECT, alloc);
+            Object &           members = val.getObject();
+
+            members.reserve(obj->size());
+            for ( JsonObject::const_iterator jIter = obj->begin(); jIter != obj->end(); ++jIter )
+                members.emplace_back(JsonValue(jIter->first, alloc),
+                                     JsonValue::FromType(jIter->second, alloc));
+            return val;
+        }
+        case JSON_ARRAY: {
+            const JsonArray * ary = (const JsonArray*) item;
+            JsonValue         val(JSON_ARRAY, alloc);
+            Array &           items = val.getArray();
+
+            items.reserve(ary->size());
+            for ( const JsonType * elem : ary->items() )
+                items.push_back(JsonValue::FromType(elem, alloc));
+            return val;
+        }
+        case JSON_NUMBER: {
+            const JsonNumber * num = (const JsonNumber*) item;
+            if ( num->getNumberType() == JSON_NUMBER_INT64 )
+                return JsonValue(num->getInteger());
+            if ( num->getNumberType() == JSON_NUMBER_UINT64 )
+                return JsonValue(num->getUnsigned());
+            return JsonValue(num->value());
+        }
+        case JSON_STRING:
+            return JsonValue(std::string_view(((const JsonString*) item)->value()), alloc);
+        case JSON_BOOLEAN:
+            return JsonValue(((const JsonBoolean*) item)->value());
+        case JSON_NULL:
+        default:
+            break;
+    }
+
+    return JsonValue();
+}
+
+// ------------------------------------------------------------------------- //
+
+} // namespace
+
+// _TCAJSON_JSONVALUE_CPP_
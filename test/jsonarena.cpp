@@ -0,0 +1,100 @@
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <memory_resource>
+
+#include "JSON.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  Builds a request document of 'count' user records */
+std::string
+makeRequest ( size_t count )
+{
+    std::string  doc = "{ \"request\" : \"users\", \"users\" : [\n";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        if ( i > 0 )
+            doc.append(",\n");
+        doc.append("{ \"id\" : " + id + ", \"name\" : \"user-" + id + "-with-a-longer-name\""
+            + ", \"email\" : \"user" + id + "@example.com\", \"tags\" : [ \"a\", \"b\" ]"
+            + ", \"score\" : " + std::to_string(i % 100) + ".5, \"active\" : true }");
+    }
+    doc.append("\n] }\n");
+
+    return doc;
+}
+
+
+/*  Parses the same request repeatedly into one document, freeing each
+ *  value individually, releasing them with an arena, drawing their
+ *  members from a pool resource of the caller, and reusing the values
+ *  of the previous parse.
+ */
+int main ( int argc, char **argv )
+{
+    size_t count = 1000;
+    int    iters = 500;
+
+    if ( argc > 1 )
+        count = std::stoul(argv[1]);
+    if ( argc > 2 )
+        iters = std::stoi(argv[2]);
+
+    std::string  doc = makeRequest(count);
+    std::string  result[4];
+
+    std::pmr::unsynchronized_pool_resource  pool;
+    const char * names[] = { "(heap)   ", "(arena)  ", "(pool)   ", "(recycle)" };
+
+    std::cout << "request document, " << count << " records, "
+        << doc.size() << " bytes, " << iters << " parses" << std::endl;
+
+    for ( int mode = 0; mode < 4; ++mode )
+    {
+        JSON  json;
+
+        if ( mode == 1 )
+            json.setUseArena(true);
+        else if ( mode == 2 )
+            json.setMemoryResource(&pool);
+        else if ( mode == 3 )
+            json.setRecycleLimit(count * 32);
+
+        bench_clock::time_point t0 = bench_clock::now();
+
+        for ( int i = 0; i < iters; ++i )
+        {
+            if ( ! json.parse(doc) ) {
+                std::cout << "Json parsing failed at position: " << json.getErrorPos()
+                    << " >> '" << json.getErrorStr() << "'" << std::endl;
+                return -1;
+            }
+        }
+
+        bench_clock::time_point t1 = bench_clock::now();
+
+        double secs = std::chrono::duration<double>(t1 - t0).count();
+        double mbs  = (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs;
+
+        std::cout << "  JSON::parse " << names[mode] << ": "
+            << mbs << " MB/s";
+        if ( mode == 1 )
+            std::cout << ", arena " << json.getArena()->getSize() << " bytes in "
+                << json.getArena()->getBlockCount() << " block(s)";
+        std::cout << std::endl;
+
+        result[mode] = JSON::ToString(json.getRoot());
+    }
+
+    bool same = (result[0] == result[1] && result[0] == result[2] && result[0] == result[3]);
+
+    std::cout << "  arena, pool and recycled documents " << (same ? "match" : "DIFFER from")
+        << " the heap document" << std::endl;
+
+    return same ? 0 : -1;
+}
@@ -0,0 +1,234 @@
+
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <set>
+
+#include "JSON.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  Builds a document holding a single array of 'count' numbers  */
+std::string
+makeArray ( size_t count, bool floats )
+{
+    std::mt19937_64  rng(42);
+    std::string      doc = "{ \"samples\" : [ ";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        if ( i > 0 )
+            doc.append(", ");
+        if ( floats ) {
+            std::uniform_real_distribution<double> dist(-1.0e6, 1.0e6);
+            doc.append(std::to_string(dist(rng)));
+        } else {
+            std::uniform_int_distribution<long> dist(0, 4000000000L);
+            doc.append(std::to_string(dist(rng)));
+        }
+    }
+    doc.append(" ] }");
+
+    return doc;
+}
+
+
+/*  The number conversion used prior to the from_chars scanner: a
+ *  std::set of valid characters built per call and a stringstream
+ *  conversion via JSON::FromString.
+ */
+double
+legacyNumber ( const char *& p, const char * end )
+{
+    const char nums[] = "-+.eE0123456789";
+    std::set<char> numset;
+    std::string    numstr;
+
+    for ( size_t i = 0; i < sizeof(nums); ++i )
+        numset.insert(nums[i]);
+
+    while ( p < end && numset.find(*p) != numset.end() )
+        numstr.push_back(*p++);
+
+    return JSON::FromString<double>(numstr);
+}
+
+
+double
+runLegacy ( const std::string & doc, int iters )
+{
+    double sum = 0.0;
+
+    for ( int i = 0; i < iters; ++i ) {
+        const char * p   = doc.data();
+        const char * end = p + doc.size();
+
+        while ( p < end ) {
+            if ( (*p >= '0' && *p <= '9') || *p == '-' )
+                sum += legacyNumber(p, end);
+            else
+                ++p;
+        }
+    }
+
+    return sum;
+}
+
+
+/*  Builds a pretty-printed document of 'count' inventory records  */
+std::string
+makeInventory ( size_t count )
+{
+    std::string  doc = "{\n  \"inventory\" : [\n";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        if ( i > 0 )
+            doc.append(",\n");
+        doc.append("    {\n      \"id\" : " + id + ",\n");
+        doc.append("      \"host\" : \"host-" + id + ".example.com\",\n");
+        doc.append("      \"path\" : \"/var/lib/inventory/\\\"" + id + "\\\"\",\n");
+        doc.append("      \"tags\" : [ \"eth\", \"ip\", \"tcp\" ],\n");
+        doc.append("      \"site\" : \"Z\u00fcrich \u2013 \u6771\u4eac \U0001F5A5\",\n");
+        doc.append("      \"load\" : 0." + id + ",\n");
+        doc.append("      \"active\" : true\n    }");
+    }
+    doc.append("\n  ]\n}\n");
+
+    return doc;
+}
+
+
+bool
+runParse ( const std::string & doc, int iters, bool indexed = false,
+           bool utf8 = false )
+{
+    JSON j;
+
+    j.setValidateUtf8(utf8);
+
+    for ( int i = 0; i < iters; ++i ) {
+        bool p = indexed ? j.parseIndexed(doc) : j.parse(doc);
+        if ( ! p ) {
+            std::cout << "Json parsing failed at position: " << j.getErrorPos()
+                << " >> '" << j.getErrorStr() << "'" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void
+report ( const std::string & name, const std::string & doc, size_t count,
+         int iters, bench_clock::duration elapsed )
+{
+    double secs = std::chrono::duration<double>(elapsed).count();
+    double mbs  = (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs;
+    double nsn  = secs * 1.0e9 / (double)(count * iters);
+
+    std::cout << "  " << name << ": " << mbs << " MB/s, "
+        << nsn << " ns/number" << std::endl;
+}
+
+
+void
+report ( const std::string & name, const std::string & doc, int iters,
+         bench_clock::duration elapsed )
+{
+    double secs = std::chrono::duration<double>(elapsed).count();
+    double mbs  = (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs;
+
+    std::cout << "  " << name << ": " << mbs << " MB/s" << std::endl;
+}
+
+
+int main ( int argc, char **argv )
+{
+    size_t count = 100000;
+    int    iters = 20;
+
+    if ( argc > 1 )
+        count = std::stoul(argv[1]);
+    if ( argc > 2 )
+        iters = std::stoi(argv[2]);
+
+    for ( int f = 0; f < 2; ++f )
+    {
+        bool         floats = (f == 1);
+        std::string  doc    = makeArray(count, floats);
+
+        std::cout << (floats ? "float-dense" : "integer-dense") << " array, "
+            << count << " numbers, " << doc.size() << " bytes" << std::endl;
+
+        bench_clock::time_point t0 = bench_clock::now();
+        volatile double sum = runLegacy(doc, iters);
+        bench_clock::time_point t1 = bench_clock::now();
+        (void) sum;
+
+        report("legacy conversion ", doc, count, iters, t1 - t0);
+
+        t0 = bench_clock::now();
+        if ( ! runParse(doc, iters) )
+            return -1;
+        t1 = bench_clock::now();
+
+        report("JSON::parse       ", doc, count, iters, t1 - t0);
+
+        t0 = bench_clock::now();
+        if ( ! runParse(doc, iters, true) )
+            return -1;
+        t1 = bench_clock::now();
+
+        report("JSON::parseIndexed", doc, count, iters, t1 - t0);
+    }
+
+    std::string  doc = makeInventory(count);
+    JsonIndex    idx;
+
+    std::cout << "inventory document, " << count << " records, "
+        << doc.size() << " bytes" << std::endl;
+
+    bench_clock::time_point t0 = bench_clock::now();
+    for ( int i = 0; i < iters; ++i )
+        idx.build(doc);
+    bench_clock::time_point t1 = bench_clock::now();
+
+    report("JsonIndex::build (" + JsonIndex::Implementation() + ")", doc, iters, t1 - t0);
+
+    t0 = bench_clock::now();
+    if ( ! runParse(doc, iters) )
+        return -1;
+    t1 = bench_clock::now();
+
+    report("JSON::parse        ", doc, iters, t1 - t0);
+
+    t0 = bench_clock::now();
+    if ( ! runParse(doc, iters, true) )
+        return -1;
+    t1 = bench_clock::now();
+
+    report("JSON::parseIndexed ", doc, iters, t1 - t0);
+
+    t0 = bench_clock::now();
+    if ( ! runParse(doc, iters, false, true) )
+        return -1;
+    t1 = bench_clock::now();
+
+    report("JSON::parse (utf-8)", doc, iters, t1 - t0);
+
+    t0 = bench_clock::now();
+    for ( int i = 0; i < iters; ++i ) {
+        if ( ! JSON::IsValidUtf8(doc) )
+            return -1;
+    }
+    t1 = bench_clock::now();
+
+    report("JSON::IsValidUtf8  ", doc, iters, t1 - t0);
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+
+#include <string>
+#include <iostream>
+#include <sstream>
+
+#include "JsonLines.h"
+using namespace tcajson;
+
+
+/*  Reads newline-delimited JSON from the file given, or from a small
+ *  sample containing a malformed record, reporting each bad line and
+ *  the overall throughput.
+ */
+int main ( int argc, char **argv )
+{
+    JsonLines  reader;
+    size_t     keys = 0;
+
+    std::istringstream  sample(
+        "{ \"id\" : 1, \"host\" : \"a.example.com\" }\n"
+        "{ \"id\" : 2, \"host\" : \"b.example.com\" }\r\n"
+        "\n"
+        "{ \"id\" : 3, \"host\" : \"c.example.com\" \n"
+        "[ \"batch\", 4 ]\n"
+        "{ \"id\" : 5, \"host\" : \"e.example.com\" }");
+
+    if ( argc > 1 ) {
+        if ( ! reader.open(argv[1]) ) {
+            std::cout << "Error opening file " << argv[1] << std::endl;
+            return -1;
+        }
+    } else {
+        reader.assign(sample);
+    }
+
+    while ( reader.next() )
+    {
+        if ( ! reader.valid() ) {
+            std::cout << "line " << reader.getLineNumber() << ": parse error at "
+                << reader.getErrorPos() << " >> '" << reader.getErrorStr()
+                << "'" << std::endl;
+            continue;
+        }
+
+        JsonType * root = reader.getRoot();
+
+        if ( root->getType() == JSON_OBJECT )
+            keys += ((JsonObject*) root)->size();
+
+        if ( argc == 1 )
+            std::cout << "line " << reader.getLineNumber() << ": " << *root << std::endl;
+    }
+
+    std::cout << reader.getRecordCount() << " records, "
+        << reader.getErrorCount() << " errors, "
+        << reader.getByteCount() << " bytes, " << keys << " keys" << std::endl
+        << (size_t) reader.getRecordsPerSec() << " records/s, "
+        << reader.getBytesPerSec() / (1024.0 * 1024.0) << " MB/s" << std::endl;
+
+    return 0;
+}
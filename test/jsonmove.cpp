@@ -0,0 +1,151 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <chrono>
+
+#include "JSON.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  Builds a document of 'count' event records */
+std::string
+makeEvents ( size_t count )
+{
+    std::string  doc = "{ \"source\" : \"collector\", \"events\" : [\n";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        if ( i > 0 )
+            doc.append(",\n");
+        doc.append("{ \"id\" : " + id + ", \"host\" : \"host-" + id + ".example.com\""
+            + ", \"level\" : \"info\", \"tags\" : [ \"a\", \"b\" ], \"ok\" : true }");
+    }
+    doc.append("\n] }\n");
+
+    return doc;
+}
+
+
+/*  Parses a document with each stage of a small pipeline */
+JSON
+parseStage ( const std::string & doc, bool arena )
+{
+    JSON  json;
+
+    json.setUseArena(arena);
+    json.parse(doc);
+
+    return json;
+}
+
+
+bool
+check ( bool ok, const std::string & what )
+{
+    if ( ! ok )
+        std::cout << "  FAILED: " << what << std::endl;
+    return ok;
+}
+
+
+/*  Compares copying and moving parsed documents between stages, and
+ *  checks that moved, released and emplaced values keep their content.
+ */
+int main ( int argc, char **argv )
+{
+    size_t count = 10000;
+    int    iters = 100;
+    bool   ok    = true;
+
+    if ( argc > 1 )
+        count = std::stoul(argv[1]);
+    if ( argc > 2 )
+        iters = std::stoi(argv[2]);
+
+    std::string  doc = makeEvents(count);
+    JSON         src(doc);
+    std::string  expect = JSON::ToString(src.getRoot());
+
+    std::cout << "event document, " << count << " records, "
+        << doc.size() << " bytes" << std::endl;
+
+    for ( int arena = 0; arena < 2; ++arena )
+    {
+        JSON  a = parseStage(doc, arena);
+
+        ok &= check(JSON::ToString(a.getRoot()) == expect, "returned document");
+
+        bench_clock::time_point t0 = bench_clock::now();
+        for ( int i = 0; i < iters; ++i ) {
+            JSON  b(a);
+            a = b;
+        }
+        bench_clock::time_point t1 = bench_clock::now();
+
+        double copyms = std::chrono::duration<double, std::milli>(t1 - t0).count() / iters;
+
+        t0 = bench_clock::now();
+        for ( int i = 0; i < iters; ++i ) {
+            JSON  b(std::move(a));
+            a = std::move(b);
+        }
+        t1 = bench_clock::now();
+
+        double movems = std::chrono::duration<double, std::milli>(t1 - t0).count() / iters;
+
+        std::cout << "  " << (arena ? "(arena) " : "(heap)  ") << "copy: " << copyms
+            << " ms, move: " << movems << " ms" << std::endl;
+
+        ok &= check(JSON::ToString(a.getRoot()) == expect, "moved document");
+
+        std::vector<JSON>  docs;
+        for ( int i = 0; i < 4; ++i )
+            docs.push_back(parseStage(doc, arena));
+        docs.push_back(std::move(a));
+
+        ok &= check(a.empty() && a.getUseArena() == (bool) arena, "moved-from document");
+        ok &= check(a.parse(doc) && JSON::ToString(a.getRoot()) == expect, "reused document");
+        ok &= check(JSON::ToString(docs.back().getRoot()) == expect, "stored document");
+
+        JsonType * root = docs.front().release();
+
+        ok &= check(JSON::ToString(root) == expect, "released root");
+        ok &= check(docs.front().empty(), "released document");
+        delete root;
+    }
+
+    JsonObject  obj;
+    JsonArray * ary = obj.emplace<JsonArray>("items");
+
+    ary->emplace<JsonNumber>((int64_t) 1);
+    ary->emplace<JsonString>("two");
+    ary->insert(std::make_unique<JsonBoolean>(true));
+    obj.insert("name", std::make_unique<JsonString>("list"));
+
+    try {
+        obj.insert("name", std::make_unique<JsonString>("again"));
+        ok &= check(false, "duplicate insert");
+    } catch ( const std::runtime_error & err ) {}
+
+    ok &= check(obj.toString() == "{ \"items\" : [ 1, \"two\", true ], \"name\" : \"list\" }",
+        "emplaced values: " + obj.toString());
+
+    JsonObject  moved(std::move(obj));
+
+    ok &= check(obj.empty() && moved.size() == 2, "moved object");
+
+    JsonObject * inner = moved.emplace<JsonObject>("inner");
+
+    inner->emplace<JsonNumber>("x", (int64_t) 1);
+    moved = std::move(*inner);
+
+    ok &= check(moved.toString() == "{ \"x\" : 1 }", "object assigned from a member");
+
+    std::cout << "  move checks " << (ok ? "passed" : "FAILED") << std::endl;
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,135 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+
+#include "JSON.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  Builds an object of 'count' members, named as a typical record */
+void
+makeObject ( JsonObject & obj, std::vector<std::string> & keys, size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        keys.push_back("field_" + std::to_string(i) + "_name");
+        obj.insert(keys.back(), new JsonNumber((int64_t) i));
+    }
+}
+
+
+/*  Verifies that each remaining member is found at its position, and
+ *  that no erased member is found.
+ */
+bool
+checkMembers ( const JsonObject & obj, const std::vector<std::string> & keys )
+{
+    size_t  i = 0;
+
+    for ( JsonObject::const_iterator jIter = obj.begin(); jIter != obj.end(); ++jIter, ++i ) {
+        if ( obj.find(jIter->first) != jIter )
+            return false;
+    }
+
+    for ( const std::string & key : keys ) {
+        if ( obj.exists(key) != (obj.find(key) != obj.end()) )
+            return false;
+    }
+
+    return i == obj.size();
+}
+
+
+/*  Looks up every member of objects of various sizes, small objects
+ *  being searched linearly and larger ones through the hash index,
+ *  and verifies that the members iterate in insertion order. Members
+ *  are then erased by key, by position and by range.
+ */
+int main ( int argc, char **argv )
+{
+    size_t  lookups = 20000000;
+    size_t  sizes[] = { 5, 15, 30, 100, 1000 };
+
+    if ( argc > 1 )
+        lookups = std::stoul(argv[1]);
+
+    for ( size_t count : sizes )
+    {
+        JsonObject                obj;
+        std::vector<std::string>  keys;
+        int64_t                   sum = 0;
+        size_t                    i   = 0;
+
+        makeObject(obj, keys, count);
+
+        for ( JsonObject::iterator jIter = obj.begin(); jIter != obj.end(); ++jIter, ++i ) {
+            if ( std::string_view(jIter->first) != keys[i] ) {
+                std::cout << "  members are not in insertion order" << std::endl;
+                return -1;
+            }
+        }
+
+        bench_clock::time_point t0 = bench_clock::now();
+
+        for ( i = 0; i < lookups; ++i )
+            sum += ((JsonNumber*) obj[keys[i % count]])->getInteger();
+
+        bench_clock::time_point t1 = bench_clock::now();
+
+        double nsecs = std::chrono::duration<double, std::nano>(t1 - t0).count();
+
+        std::cout << "  " << count << " members: " << (nsecs / lookups)
+            << " ns/lookup (checksum " << sum << ")" << std::endl;
+
+        if ( obj["missing"] != nullptr || obj.exists("field_0_nam") ) {
+            std::cout << "  lookup of a missing key succeeded" << std::endl;
+            return -1;
+        }
+    }
+
+    JsonObject                obj;
+    std::vector<std::string>  keys;
+    size_t                    count = 20000;
+
+    makeObject(obj, keys, count);
+
+    bench_clock::time_point t0 = bench_clock::now();
+
+    for ( size_t i = 0; i < count; i += 2 ) {
+        JsonType * item = obj[keys[i]];   // not deleted by erase of a key
+        obj.erase(keys[i]);
+        delete item;
+    }
+
+    bench_clock::time_point t1 = bench_clock::now();
+
+    bool ok = (obj.size() == count / 2) && checkMembers(obj, keys);
+
+    for ( JsonObject::iterator jIter = obj.begin(); ok && jIter != obj.end(); ) {
+        if ( std::string_view(jIter->first).ends_with("5_name") )
+            jIter = obj.erase(jIter);
+        else
+            ++jIter;
+    }
+
+    ok = ok && (obj.size() == count * 2 / 5) && checkMembers(obj, keys);
+
+    obj.erase(obj.begin() + 10, obj.begin() + 20);
+    ok = ok && (obj.size() == count * 2 / 5 - 10) && checkMembers(obj, keys);
+
+    obj.erase(obj.begin() + 5, obj.end());
+    ok = ok && (obj.size() == 5) && checkMembers(obj, keys);
+
+    std::cout << "  erased " << count / 2 << " of " << count << " members in "
+        << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms" << std::endl;
+
+    if ( ! ok ) {
+        std::cout << "  erased members are not found as expected" << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
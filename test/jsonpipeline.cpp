@@ -0,0 +1,102 @@
+
+#include <string>
+#include <iostream>
+#include <atomic>
+#include <thread>
+
+#include "JsonPipeline.h"
+using namespace tcajson;
+
+
+/*  Builds 'count' NDJSON records. Every 64th block of 1000 records
+ *  carries a large payload, skewing the cost of the chunks.
+ */
+std::string
+makeRecords ( size_t count )
+{
+    std::string  doc;
+    std::string  payload(2000, 'x');
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        doc.append("{ \"id\" : " + id + ", \"host\" : \"host-" + id + ".example.com\", ");
+        doc.append("\"tags\" : [ \"eth\", \"ip\", \"tcp\" ], \"load\" : 0." + id);
+        if ( (i / 1000) % 64 == 0 )
+            doc.append(", \"payload\" : \"" + payload + "\"");
+        doc.append(", \"active\" : true }\n");
+    }
+
+    return doc;
+}
+
+
+/*  Runs the pipeline across 1 to N threads, ordered and unordered,
+ *  reporting the throughput and the speedup over a single thread.
+ *  Usage: jsonpipeline [file.ndjson | count] [max_threads]
+ */
+int main ( int argc, char **argv )
+{
+    std::string  doc;
+    std::string  fn;
+    size_t       maxt  = std::thread::hardware_concurrency();
+
+    if ( argc > 1 && std::isdigit((unsigned char) argv[1][0]) )
+        doc = makeRecords(std::stoul(argv[1]));
+    else if ( argc > 1 )
+        fn = argv[1];
+    else
+        doc = makeRecords(200000);
+
+    if ( argc > 2 )
+        maxt = std::stoul(argv[2]);
+    if ( maxt == 0 )
+        maxt = 1;
+
+    for ( int m = 0; m < 2; ++m )
+    {
+        bool    ordered = (m == 0);
+        double  base    = 0.0;
+
+        std::cout << (ordered ? "ordered" : "unordered") << std::endl;
+
+        for ( size_t t = 1; t <= maxt; t *= 2 )
+        {
+            JsonPipeline         pipe(t, ordered);
+            std::atomic<size_t>  keys(0);
+            size_t               last = 0;
+            bool                 inorder = true;
+
+            JsonPipeline::Consumer  consumer = [&] ( JsonRecord & rec ) {
+                if ( ! rec.valid )
+                    return;
+                if ( ordered ) {
+                    inorder = inorder && (rec.lineno > last);
+                    last    = rec.lineno;
+                }
+                keys += rec.doc->getJSON().size();
+            };
+
+            bool r = fn.empty() ? pipe.run(doc, consumer) : pipe.runFile(fn, consumer);
+
+            if ( ! r ) {
+                std::cout << pipe.getErrorStr() << std::endl;
+                return -1;
+            }
+
+            double mbs = pipe.getBytesPerSec() / (1024.0 * 1024.0);
+            if ( t == 1 )
+                base = mbs;
+
+            std::cout << "  threads " << t << ": " << mbs << " MB/s, "
+                << (size_t) pipe.getRecordsPerSec() << " records/s, speedup "
+                << (mbs / base) << "x (" << pipe.getRecordCount() << " records, "
+                << pipe.getErrorCount() << " errors, " << keys << " keys"
+                << (inorder ? "" : ", OUT OF ORDER") << ")" << std::endl;
+
+            if ( t < maxt && t * 2 > maxt )
+                t = maxt / 2;
+        }
+    }
+
+    return 0;
+}
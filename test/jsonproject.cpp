@@ -0,0 +1,157 @@
+#include <string>
+#include <iostream>
+#include <chrono>
+
+#include "JSON.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  Builds an array of 'count' flow events of about 60 fields each,
+ *  of which a consumer typically reads only a handful.
+ */
+std::string
+makeEvents ( size_t count )
+{
+    std::string  doc = "[\n";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        if ( i > 0 )
+            doc.append(",\n");
+        doc.append("{ \"id\" : " + id + ", \"src_ip\" : \"10.0." + std::to_string(i % 256)
+            + ".1\", \"dst_ip\" : \"192.168.1." + std::to_string(i % 256) + "\"");
+        doc.append(", \"aspath\" : [ 65001, 65002, " + std::to_string(64512 + (i % 1000)) + " ]");
+        for ( int f = 0; f < 56; ++f ) {
+            std::string fs = std::to_string(f);
+            if ( f % 3 == 0 )
+                doc.append(", \"field" + fs + "\" : \"value-" + fs + "-\\\"" + id + "\\\"\"");
+            else if ( f % 3 == 1 )
+                doc.append(", \"field" + fs + "\" : " + std::to_string(i * f) + "." + fs);
+            else
+                doc.append(", \"field" + fs + "\" : { \"a\" : [ 1, 2, \"]}\" ], \"b\" : null }");
+        }
+        doc.append(", \"bytes\" : " + std::to_string(i * 1500) + " }");
+    }
+    doc.append("\n]\n");
+
+    return doc;
+}
+
+
+void
+report ( const std::string & name, const std::string & doc, int iters,
+         bench_clock::duration elapsed, uint64_t sum )
+{
+    double secs = std::chrono::duration<double>(elapsed).count();
+    double mbs  = (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs;
+
+    std::cout << "  " << name << ": " << mbs << " MB/s (checksum " << sum << ")"
+        << std::endl;
+}
+
+
+uint64_t
+readEvents ( JSON & json )
+{
+    uint64_t  sum = 0;
+
+    for ( JsonType * item : json.getArray() ) {
+        JsonObject & ev = *((JsonObject*) item);
+        sum += ((JsonString*) ev["src_ip"])->value().size();
+        sum += ((JsonString*) ev["dst_ip"])->value().size();
+        sum += ((JsonNumber*) ev["bytes"])->getUnsigned();
+        for ( JsonType * asn : *((JsonArray*) ev["aspath"]) )
+            sum += ((JsonNumber*) asn)->getUnsigned();
+    }
+
+    return sum;
+}
+
+
+/*  Reads four fields of every event, from the full tree of JSON::parse
+ *  and from a tree projected to only those fields, and verifies that
+ *  the projected events hold the same values.
+ */
+int main ( int argc, char **argv )
+{
+    size_t count = 20000;
+    int    iters = 5;
+
+    if ( argc > 1 )
+        count = std::stoul(argv[1]);
+    if ( argc > 2 )
+        iters = std::stoi(argv[2]);
+
+    std::string     doc = makeEvents(count);
+    JsonProjection  proj({ "/src_ip", "/dst_ip", "/aspath", "/bytes" });
+    JSON            json, projected;
+    uint64_t        sum = 0;
+
+    std::cout << "field-sparse events, " << count << " records, "
+        << doc.size() << " bytes" << std::endl;
+
+    bench_clock::time_point t0 = bench_clock::now();
+
+    for ( int i = 0; i < iters; ++i )
+    {
+        if ( ! json.parse(doc) ) {
+            std::cout << "Json parsing failed at position: " << json.getErrorPos()
+                << " >> '" << json.getErrorStr() << "'" << std::endl;
+            return -1;
+        }
+        sum += readEvents(json);
+    }
+
+    bench_clock::time_point t1 = bench_clock::now();
+
+    report("JSON::parse          ", doc, iters, t1 - t0, sum);
+
+    sum = 0;
+    t0  = bench_clock::now();
+
+    for ( int i = 0; i < iters; ++i )
+    {
+        if ( ! projected.parse(doc, proj) ) {
+            std::cout << "Json parsing failed at position: " << projected.getErrorPos()
+                << " >> '" << projected.getErrorStr() << "'" << std::endl;
+            return -1;
+        }
+        sum += readEvents(projected);
+    }
+
+    t1 = bench_clock::now();
+
+    report("JSON::parse projected", doc, iters, t1 - t0, sum);
+
+    JsonArray & full = json.getArray();
+    JsonArray & part = projected.getArray();
+    bool        same = (full.size() == part.size());
+
+    for ( size_t i = 0; same && i < part.size(); ++i ) {
+        JsonObject & ev  = *((JsonObject*) full.at(i));
+        JsonObject & pev = *((JsonObject*) part.at(i));
+
+        same = (pev.size() == 4);
+
+        for ( const char * key : { "src_ip", "dst_ip", "aspath", "bytes" } ) {
+            if ( same && JSON::ToString(pev[key]) != JSON::ToString(ev[key]) )
+                same = false;
+        }
+    }
+
+    std::cout << "  projected events " << (same ? "match" : "DIFFER from")
+        << " the parsed tree" << std::endl;
+
+    /*  A document truncated after an escape in a skipped string  */
+    std::string  cut = "[ { \"src_ip\" : \"10.0.0.1\", \"path\" : \"a\\";
+
+    if ( projected.parse(cut, proj) ) {
+        std::cout << "  truncated document was accepted" << std::endl;
+        same = false;
+    }
+
+    return same ? 0 : -1;
+}
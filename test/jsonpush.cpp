@@ -0,0 +1,78 @@
+
+#include <string>
+#include <iostream>
+
+#include "JsonPushParser.h"
+using namespace tcajson;
+
+
+/*  Feeds two concatenated documents to the push parser in fragments
+ *  of 'frag' bytes, as they might arrive from a socket, then checks
+ *  that finish() completes a bare root scalar and fails truncated
+ *  documents.
+ *  Usage: jsonpush [fragment_size]
+ */
+int main ( int argc, char **argv )
+{
+    JsonPushParser  parser;
+    size_t          frag = 7;
+
+    std::string  input =
+        "{ \"src_ip\" : \"74.125.224.65\", \"src_port\" : 80, "
+        "\"path\" : [ \"eth\", \"ip\", \"tcp\", \"http\", \"youtube\" ], "
+        "\"name\" : \"caf\\u00e9 \\ud83d\\ude00\", \"bytes_in\" : 60 }\n"
+        "[ 1, 2.5, true, null, { \"nested\" : [ ] } ]\n";
+
+    if ( argc > 1 )
+        frag = std::stoul(argv[1]);
+    if ( frag == 0 )
+        frag = 1;
+
+    const char * p   = input.data();
+    const char * end = p + input.size();
+
+    while ( p < end )
+    {
+        size_t   len = std::min(frag, (size_t)(end - p));
+        jfeed_t  st  = parser.feed(p, len);
+
+        if ( st == JSON_FEED_ERROR ) {
+            std::cout << "Json parsing failed at position: " << parser.getErrorPos()
+                << " >> '" << parser.getErrorStr() << "'" << std::endl;
+            return -1;
+        }
+
+        if ( st == JSON_FEED_COMPLETE ) {
+            std::cout << JSON::TypeToString(parser.getRoot()->getType()) << " : "
+                << *parser.getRoot() << std::endl;
+            p += parser.getConsumed();
+            parser.reset();
+            continue;
+        }
+
+        p += len;
+    }
+
+    const char * truncated[] = { "[1", "[true", "{\"a\": 12", "{\"a\":[1,2", "{\"a\"", "[" };
+
+    parser.reset();
+    parser.feed("42", 2);
+
+    if ( parser.finish() != JSON_FEED_COMPLETE ) {
+        std::cout << "finish() failed a complete root number" << std::endl;
+        return -1;
+    }
+
+    for ( const char * doc : truncated )
+    {
+        parser.reset();
+        parser.feed(doc, std::char_traits<char>::length(doc));
+
+        if ( parser.finish() != JSON_FEED_ERROR ) {
+            std::cout << "finish() completed the truncated document '" << doc << "'" << std::endl;
+            return -1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+
+#include "JSON.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  A handler totalling the "load" field of every record, along with
+ *  a count of the objects and values seen. Keys are only compared,
+ *  so no event allocates.
+ */
+class LoadHandler : public JsonHandler {
+  public:
+    size_t  objects = 0;
+    size_t  values  = 0;
+    double  total   = 0.0;
+    bool    isload  = false;
+
+    bool  startObject() { ++objects; return true; }
+
+    bool  key ( std::string_view k )
+    {
+        isload = (k == "load");
+        return true;
+    }
+
+    bool  number ( double val )
+    {
+        if ( isload )
+            total += val;
+        ++values;
+        return true;
+    }
+
+    bool  integer  ( int64_t val )   { return this->number((double) val); }
+    bool  uinteger ( uint64_t val )  { return this->number((double) val); }
+    bool  string   ( std::string_view ) { ++values; return true; }
+    bool  boolean  ( bool )          { ++values; return true; }
+    bool  null()                     { ++values; return true; }
+};
+
+
+/*  Builds a document of 'count' records  */
+std::string
+makeRecords ( size_t count )
+{
+    std::string  doc = "[\n";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        if ( i > 0 )
+            doc.append(",\n");
+        doc.append("  { \"id\" : " + id + ", \"host\" : \"host-" + id + ".example.com\", ");
+        doc.append("\"tags\" : [ \"eth\", \"ip\" ], \"load\" : 0." + id + ", \"active\" : true }");
+    }
+    doc.append("\n]\n");
+
+    return doc;
+}
+
+
+/*  Sums the "load" fields of the document given, or of a generated
+ *  document, with the event parser and then by walking the tree built
+ *  by JSON::parse, reporting the throughput of each.
+ */
+int main ( int argc, char **argv )
+{
+    std::string  doc;
+
+    if ( argc > 1 ) {
+        std::ifstream  ifs(argv[1], std::ios::binary);
+        if ( ! ifs ) {
+            std::cout << "Error opening file " << argv[1] << std::endl;
+            return -1;
+        }
+        doc.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    } else {
+        doc = makeRecords(200000);
+    }
+
+    LoadHandler              handler;
+    JsonParser<LoadHandler>  parser(handler);
+
+    bench_clock::time_point t0 = bench_clock::now();
+
+    if ( ! parser.parse(doc) ) {
+        std::cout << "Json parsing failed at position: " << parser.getErrorPos()
+            << " >> '" << parser.getErrorStr() << "'" << std::endl;
+        return -1;
+    }
+
+    bench_clock::time_point t1 = bench_clock::now();
+
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    std::cout << "JsonParser : " << handler.objects << " objects, "
+        << handler.values << " values, load " << handler.total << ", "
+        << (double) doc.size() / (1024.0 * 1024.0) / secs << " MB/s" << std::endl;
+
+    JSON    json;
+    double  total = 0.0;
+
+    t0 = bench_clock::now();
+
+    if ( ! json.parse(doc) ) {
+        std::cout << "Json parsing failed at position: " << json.getErrorPos()
+            << " >> '" << json.getErrorStr() << "'" << std::endl;
+        return -1;
+    }
+
+    if ( json.getRoot()->getType() == JSON_ARRAY ) {
+        for ( JsonType * item : json.getArray() ) {
+            if ( item->getType() != JSON_OBJECT )
+                continue;
+            JsonObject & obj  = *((JsonObject*) item);
+            JsonType   * load = obj["load"];
+            if ( load != nullptr && load->getType() == JSON_NUMBER )
+                total += ((JsonNumber*) load)->value();
+        }
+    }
+
+    t1   = bench_clock::now();
+    secs = std::chrono::duration<double>(t1 - t0).count();
+
+    std::cout << "JSON::parse: load " << total << ", "
+        << (double) doc.size() / (1024.0 * 1024.0) / secs << " MB/s" << std::endl;
+
+    return 0;
+}
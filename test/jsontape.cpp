@@ -0,0 +1,136 @@
+#include <string>
+#include <iostream>
+#include <chrono>
+
+#include "JSON.h"
+#include "JsonTape.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  Builds an array of 'count' flow events of about 60 fields each,
+ *  of which a consumer typically reads only a handful.
+ */
+std::string
+makeEvents ( size_t count )
+{
+    std::string  doc = "[\n";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        if ( i > 0 )
+            doc.append(",\n");
+        doc.append("{ \"id\" : " + id + ", \"src_ip\" : \"10.0." + std::to_string(i % 256)
+            + ".1\", \"dst_ip\" : \"192.168.1." + std::to_string(i % 256) + "\"");
+        doc.append(", \"path\" : [ 65001, 65002, " + std::to_string(64512 + (i % 1000)) + " ]");
+        for ( int f = 0; f < 56; ++f ) {
+            std::string fs = std::to_string(f);
+            if ( f % 3 == 0 )
+                doc.append(", \"field" + fs + "\" : \"value-" + fs + "-" + id + "\"");
+            else if ( f % 3 == 1 )
+                doc.append(", \"field" + fs + "\" : " + std::to_string(i * f) + "." + fs);
+            else
+                doc.append(", \"field" + fs + "\" : { \"a\" : [ 1, 2, 3 ], \"b\" : null }");
+        }
+        doc.append(", \"bytes\" : " + std::to_string(i * 1500) + " }");
+    }
+    doc.append("\n]\n");
+
+    return doc;
+}
+
+
+void
+report ( const std::string & name, const std::string & doc, int iters,
+         bench_clock::duration elapsed, uint64_t sum )
+{
+    double secs = std::chrono::duration<double>(elapsed).count();
+    double mbs  = (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs;
+
+    std::cout << "  " << name << ": " << mbs << " MB/s (checksum " << sum << ")"
+        << std::endl;
+}
+
+
+/*  Reads four fields of every event, from the full tree of JSON::parse
+ *  and on demand from a JsonTape, and verifies that a materialized
+ *  tape matches the parsed tree.
+ */
+int main ( int argc, char **argv )
+{
+    size_t count = 20000;
+    int    iters = 5;
+
+    if ( argc > 1 )
+        count = std::stoul(argv[1]);
+    if ( argc > 2 )
+        iters = std::stoi(argv[2]);
+
+    std::string  doc = makeEvents(count);
+    JSON         json;
+    JsonTape     tape;
+    uint64_t     sum = 0;
+
+    std::cout << "field-sparse events, " << count << " records, "
+        << doc.size() << " bytes" << std::endl;
+
+    bench_clock::time_point t0 = bench_clock::now();
+
+    for ( int i = 0; i < iters; ++i )
+    {
+        if ( ! json.parse(doc) ) {
+            std::cout << "Json parsing failed at position: " << json.getErrorPos()
+                << " >> '" << json.getErrorStr() << "'" << std::endl;
+            return -1;
+        }
+
+        for ( JsonType * item : json.getArray() ) {
+            JsonObject & ev = *((JsonObject*) item);
+            sum += ((JsonString*) ev["src_ip"])->value().size();
+            sum += ((JsonString*) ev["dst_ip"])->value().size();
+            sum += ((JsonNumber*) ev["bytes"])->getUnsigned();
+            for ( JsonType * asn : *((JsonArray*) ev["path"]) )
+                sum += ((JsonNumber*) asn)->getUnsigned();
+        }
+    }
+
+    bench_clock::time_point t1 = bench_clock::now();
+
+    report("JSON::parse    ", doc, iters, t1 - t0, sum);
+
+    sum = 0;
+    t0  = bench_clock::now();
+
+    for ( int i = 0; i < iters; ++i )
+    {
+        if ( ! tape.parse(doc) ) {
+            std::cout << "Json parsing failed at position: " << tape.getErrorPos()
+                << " >> '" << tape.getErrorStr() << "'" << std::endl;
+            return -1;
+        }
+
+        for ( JsonCursor ev : tape.getRoot() ) {
+            sum += ev["src_ip"].getString().size();
+            sum += ev["dst_ip"].getString().size();
+            sum += ev["bytes"].getUnsigned();
+            for ( JsonCursor asn : ev["path"] )
+                sum += asn.getUnsigned();
+        }
+    }
+
+    t1 = bench_clock::now();
+
+    report("JsonTape::parse", doc, iters, t1 - t0, sum);
+
+    JsonType * root = tape.getRoot().materialize();
+    bool       same = (JSON::ToString(root) == JSON::ToString(json.getRoot()));
+
+    std::cout << "  materialized tape " << (same ? "matches" : "DIFFERS from")
+        << " the parsed tree" << std::endl;
+
+    delete root;
+
+    return same ? 0 : -1;
+}
@@ -1,7 +1,6 @@
 
 #include <string>
 #include <iostream>
-#include <fstream>
 
 #include "JSON.h"
 using namespace tcajson;
@@ -38,7 +37,7 @@ int main ( int argc, char **argv )
     JsonObject::iterator  jIter;
     for ( jIter = root.begin(); jIter != root.end(); ++jIter )
     {
-        const std::string & key  = jIter->first;
+        std::string_view    key  = jIter->first;
         JsonType          * item = jIter->second;
 
         std::cout << key << " : " << JSON::TypeToString(item->getType())
@@ -48,6 +47,38 @@ int main ( int argc, char **argv )
     std::cout << std::endl;
     std::cout << root << std::endl;
 
+    /*  Integers are kept exact, without a round trip through double  */
+    JsonNumber * etime = (JsonNumber*) root["end_time"];
+
+    if ( etime->isInteger() )
+        std::cout << "end_time : " << etime->getInteger() << std::endl;
+
+    /*  A double set on an integer replaces it  */
+    JsonNumber  num;
+
+    num.setInteger(etime->getInteger());
+    num.setDouble(1.5);
+
+    if ( num.isInteger() || num.getInteger() != 1 || num.toString() != "1.5" ) {
+        std::cout << "Number set to a double still reads as "
+            << num.toString() << std::endl;
+        return -1;
+    }
+
+    /*  A number too large for a double is rejected, a small one underflows  */
+    JSON  range;
+
+    if ( range.parse("{ \"b\" : 1e400 }") || range.getErrorPos() != 8 ) {
+        std::cout << "Out of range number was accepted: "
+            << JSON::ToString(range.getRoot()) << std::endl;
+        return -1;
+    }
+
+    if ( ! range.parse("{ \"b\" : -1e-400 }") || ! range.json()["b"] ) {
+        std::cout << "Underflowing number was rejected" << std::endl;
+        return -1;
+    }
+
     /*  Create a structure from scratch  */
     std::cout << " --- " << std::endl;
 
@@ -68,23 +99,17 @@ int main ( int argc, char **argv )
         return 0;
 
     const char  * fn = argv[1];
-    std::ifstream ifs(fn);
-
-    if ( ! ifs )
-        std::cout << "Error opening file " << fn << std::endl;
 
-    std::istream & buf = (std::istream&) ifs;
-
-    j.clear();
-    if ( ! j.parse(buf) ) {
+    if ( ! j.parseFile(fn) ) {
         std::cout << "Json parsing failed at position: " << j.getErrorPos() 
             << " >> '" << j.getErrorStr() << "'" << std::endl;
         return -1;
     }
-    root = j.json();
 
+    /*  The document root may be of any type  */
     std::cout << std::endl;
-    std::cout << root << std::endl;
+    std::cout << JSON::TypeToString(j.getRoot()->getType()) << " : "
+        << *j.getRoot() << std::endl;
 
     return 0;
 }
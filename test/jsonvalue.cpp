@@ -0,0 +1,355 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#include "JSON.h"
+#include "JsonValue.h"
+using namespace tcajson;
+
+
+typedef std::chrono::steady_clock  bench_clock;
+
+
+/*  Counts the bytes held from operator new, excluding malloc overhead */
+static size_t  HeapBytes = 0;
+
+void*
+operator new ( size_t sz )
+{
+    void * p = std::malloc(sz + 16);
+
+    if ( p == nullptr )
+        throw std::bad_alloc();
+
+    *((size_t*) p) = sz;
+    HeapBytes     += sz;
+
+    return (char*) p + 16;
+}
+
+void
+operator delete ( void * p ) noexcept
+{
+    if ( p == nullptr )
+        return;
+
+    p = (char*) p - 16;
+    HeapBytes -= *((size_t*) p);
+    std::free(p);
+}
+
+void
+operator delete ( void * p, size_t ) noexcept
+{
+    ::operator delete(p);
+}
+
+/*  the default memory resource allocates with an alignment */
+void*
+operator new ( size_t sz, std::align_val_t )
+{
+    return ::operator new(sz);
+}
+
+void
+operator delete ( void * p, std::align_val_t ) noexcept
+{
+    ::operator delete(p);
+}
+
+void
+operator delete ( void * p, size_t, std::align_val_t ) noexcept
+{
+    ::operator delete(p);
+}
+
+
+/*  Builds a document of 'count' cached flow records of mostly scalars */
+std::string
+makeFlows ( size_t count )
+{
+    std::string  doc = "{ \"flows\" : [\n";
+
+    for ( size_t i = 0; i < count; ++i ) {
+        std::string id = std::to_string(i);
+        if ( i > 0 )
+            doc.append(",\n");
+        doc.append("{ \"id\" : " + id + ", \"src_ip\" : \"10.0." + std::to_string(i % 256)
+            + ".1\", \"dst_port\" : " + std::to_string(i % 65536) + ", \"proto\" : \"tcp\""
+            + ", \"bytes\" : " + std::to_string(i * 1500) + ", \"rtt\" : 0." + id
+            + ", \"syn\" : true, \"fin\" : false, \"vlan\" : null"
+            + ", \"path\" : [ \"eth\", \"ip\", \"tcp\" ]"
+            + ", \"host\" : \"host-" + id + ".example.com\""
+            + ", \"msg\" : \"connection " + id + " accepted from 10.0.0.1 after a"
+            + " three way handshake and forwarded to the upstream pool\" }");
+    }
+    doc.append("\n] }\n");
+
+    return doc;
+}
+
+
+uint64_t
+sumTree ( const JsonType * item )
+{
+    uint64_t  sum = 0;
+
+    switch ( item->getType() ) {
+        case JSON_OBJECT: {
+            const JsonObject * obj = (const JsonObject*) item;
+            for ( JsonObject::const_iterator jIter = obj->begin(); jIter != obj->end(); ++jIter )
+                sum += sumTree(jIter->second);
+            break;
+        }
+        case JSON_ARRAY:
+            for ( const JsonType * elem : ((const JsonArray*) item)->items() )
+                sum += sumTree(elem);
+            break;
+        case JSON_NUMBER:
+            sum += ((const JsonNumber*) item)->getUnsigned();
+            break;
+        case JSON_STRING:
+            sum += ((const JsonString*) item)->value().size();
+            break;
+        case JSON_BOOLEAN:
+            sum += ((const JsonBoolean*) item)->value();
+            break;
+        default:
+            break;
+    }
+
+    return sum;
+}
+
+
+uint64_t
+sumValue ( const JsonValue & val )
+{
+    uint64_t  sum = 0;
+
+    switch ( val.getType() ) {
+        case JSON_OBJECT:
+            for ( const JsonValue::Member & m : val.getObject() )
+                sum += sumValue(m.second);
+            break;
+        case JSON_ARRAY:
+            for ( const JsonValue & elem : val.getArray() )
+                sum += sumValue(elem);
+            break;
+        case JSON_NUMBER:
+            sum += val.getUnsigned();
+            break;
+        case JSON_STRING:
+            sum += val.size();
+            break;
+        case JSON_BOOLEAN:
+            sum += val.getBoolean();
+            break;
+        default:
+            break;
+    }
+
+    return sum;
+}
+
+
+/*  Updates one flow record of the document, as a request handler */
+void
+updateFlow ( JsonValue & doc, size_t i )
+{
+    JsonValue & flows = *doc.find("flows");
+    JsonValue & flow  = flows.getArray()[i % flows.size()];
+
+    *flow.find("proto") = JsonValue("udp");
+}
+
+
+/*  Holds the same document as a tree of JsonTypes and as JsonValues,
+ *  with strings copied and borrowed from the input, to compare the
+ *  memory they hold, and compares the time to parse and to traverse
+ *  them, and the cost of handing shared and deep copies to handlers.
+ */
+int main ( int argc, char **argv )
+{
+    size_t count = 100000;
+    int    iters = 10;
+
+    if ( argc > 1 )
+        count = std::stoul(argv[1]);
+    if ( argc > 2 )
+        iters = std::stoi(argv[2]);
+
+    std::string  doc = makeFlows(count);
+
+    std::cout << "flow records, " << count << " records, "
+        << doc.size() << " bytes" << std::endl;
+
+    JSON       json;
+    JsonValue  value;
+
+    JsonValueBuilder              builder(value);
+    JsonParser<JsonValueBuilder>  parser(builder);
+
+    size_t  base = HeapBytes;
+
+    if ( ! json.parse(doc) ) {
+        std::cout << "Json parsing failed at position: " << json.getErrorPos()
+            << " >> '" << json.getErrorStr() << "'" << std::endl;
+        return -1;
+    }
+
+    std::cout << "  JsonType tree      : " << (HeapBytes - base) << " bytes" << std::endl;
+
+    base = HeapBytes;
+
+    if ( ! parser.parse(doc) ) {
+        std::cout << "JsonValue parsing failed at position: " << parser.getErrorPos()
+            << " >> '" << parser.getErrorStr() << "'" << std::endl;
+        return -1;
+    }
+
+    std::cout << "  JsonValue          : " << (HeapBytes - base) << " bytes" << std::endl;
+
+    JsonValue                     bval;
+    JsonValueBuilder              bbuilder(bval);
+    JsonParser<JsonValueBuilder>  bparser(bbuilder);
+
+    base = HeapBytes;
+    bbuilder.setSource(doc);
+
+    if ( ! bparser.parse(doc) ) {
+        std::cout << "JsonValue parsing failed at position: " << bparser.getErrorPos()
+            << " >> '" << bparser.getErrorStr() << "'" << std::endl;
+        return -1;
+    }
+
+    std::cout << "  JsonValue borrowed : " << (HeapBytes - base) << " bytes" << std::endl;
+
+    bool same = (JSON::ToString(json.getRoot()) == value.toString());
+
+    same = same && (bval.toString() == value.toString());
+
+    JsonType * tree = value.materialize();
+    same = same && (JSON::ToString(tree) == JSON::ToString(json.getRoot()));
+    delete tree;
+
+    same = same && (JsonValue::FromType(json.getRoot()).toString() == value.toString());
+
+    uint64_t  sum = 0;
+
+    bench_clock::time_point t0 = bench_clock::now();
+    for ( int i = 0; i < iters; ++i )
+        sum += sumTree(json.getRoot());
+    bench_clock::time_point t1 = bench_clock::now();
+
+    std::cout << "  JsonType traversal : "
+        << std::chrono::duration<double, std::milli>(t1 - t0).count() / iters
+        << " ms (checksum " << sum << ")" << std::endl;
+
+    sum = 0;
+    t0  = bench_clock::now();
+    for ( int i = 0; i < iters; ++i )
+        sum += sumValue(value);
+    t1  = bench_clock::now();
+
+    std::cout << "  JsonValue traversal: "
+        << std::chrono::duration<double, std::milli>(t1 - t0).count() / iters
+        << " ms (checksum " << sum << ")" << std::endl;
+
+    JSON                          heap;
+    JsonValue                     hval;
+    JsonValueBuilder              hbuilder(hval);
+    JsonParser<JsonValueBuilder>  hparser(hbuilder);
+
+    t0 = bench_clock::now();
+    for ( int i = 0; i < iters; ++i )
+        heap.parse(doc);
+    t1 = bench_clock::now();
+
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "  JSON::parse        : "
+        << (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs << " MB/s" << std::endl;
+
+    t0 = bench_clock::now();
+    for ( int i = 0; i < iters; ++i ) {
+        hbuilder.reset();
+        hparser.parse(doc);
+    }
+    t1 = bench_clock::now();
+
+    secs = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "  JsonValue parse    : "
+        << (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs << " MB/s" << std::endl;
+
+    hbuilder.setSource(doc);
+
+    t0 = bench_clock::now();
+    for ( int i = 0; i < iters; ++i ) {
+        hbuilder.reset();
+        hparser.parse(doc);
+    }
+    t1 = bench_clock::now();
+
+    secs = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "  JsonValue borrowed : "
+        << (double)(doc.size() * iters) / (1024.0 * 1024.0) / secs << " MB/s" << std::endl;
+
+    std::string             master = value.toString();
+    std::vector<JsonValue>  copies;
+
+    base = HeapBytes;
+    t0   = bench_clock::now();
+    for ( size_t i = 0; i < 100; ++i ) {
+        copies.push_back(value.share());
+        updateFlow(copies.back(), i);
+    }
+    t1   = bench_clock::now();
+
+    std::cout << "  100 shared copies  : "
+        << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, "
+        << (HeapBytes - base) << " bytes" << std::endl;
+
+    same = same && (copies[1]["flows"][1]["proto"].getString() == "udp")
+                && (copies[1]["flows"][2]["proto"].getString() == "tcp")
+                && (value.toString() == master);
+    copies.clear();
+
+    base = HeapBytes;
+    t0   = bench_clock::now();
+    for ( size_t i = 0; i < 100 && i < (size_t) iters; ++i ) {
+        copies.push_back(JsonValue(value));
+        updateFlow(copies.back(), i);
+        if ( i == 0 )
+            base = HeapBytes - base;
+        copies.clear();
+    }
+    t1   = bench_clock::now();
+
+    std::cout << "  deep copy          : "
+        << std::chrono::duration<double, std::milli>(t1 - t0).count() / std::min(iters, 100)
+        << " ms, " << base << " bytes each" << std::endl;
+
+    same = same && (value.toString() == master);
+
+    /*  Assigning a value one of its own elements, moved or copied  */
+    JsonValue    own(value);
+    std::string  flow = value["flows"][0].toString();
+
+    own = std::move(own.getObject()[0].second);
+    own = std::move(own.getArray()[0]);
+    same = same && (own.toString() == flow);
+
+    JsonValue  shared = value.share();
+
+    shared = shared.getObject()[0].second;
+    shared = shared.getArray()[0];
+    same = same && (shared.toString() == flow) && (value.toString() == master);
+
+    std::cout << "  JsonValue documents " << (same ? "match" : "DIFFER from")
+        << " the parsed tree" << std::endl;
+
+    return same ? 0 : -1;
+}